@@ -0,0 +1,132 @@
+#include "SpectrumAnalyser.h"
+
+SpectrumAnalyser::SpectrumAnalyser()
+    : juce::Thread("Ducker SC Analyser")
+{
+    fifoBuffer.resize(fifoSize, 0.0f);
+    timeDomain.resize(fftSize, 0.0f);
+    fftData.resize(2 * fftSize, 0.0f);
+    smoothed.fill(floorDb);
+    for (auto& b : buffers)
+        b.fill(floorDb);
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    setActive(false);
+}
+
+void SpectrumAnalyser::prepare(double sampleRate)
+{
+    sampleRateForAnalysis.store(sampleRate);
+}
+
+void SpectrumAnalyser::setActive(bool shouldBeActive)
+{
+    if (shouldBeActive == isThreadRunning())
+        return;
+
+    if (shouldBeActive)
+    {
+        active.store(true);
+        startThread(juce::Thread::Priority::low);
+    }
+    else
+    {
+        active.store(false);
+        stopThread(1000);
+    }
+}
+
+void SpectrumAnalyser::pushSamples(const float* left, const float* right, int numSamples) noexcept
+{
+    if (!active.load(std::memory_order_relaxed))
+        return;
+
+    // Downmix straight into the FIFO; anything that doesn't fit is dropped
+    const auto scope = fifo.write(juce::jmin(numSamples, fifo.getFreeSpace()));
+
+    auto writeBlock = [&](int start, int size, int offset)
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            float s = left[offset + i];
+            if (right != nullptr)
+                s = (s + right[offset + i]) * 0.5f;
+            fifoBuffer[(size_t)(start + i)] = s;
+        }
+    };
+
+    writeBlock(scope.startIndex1, scope.blockSize1, 0);
+    writeBlock(scope.startIndex2, scope.blockSize2, scope.blockSize1);
+}
+
+bool SpectrumAnalyser::getLatestSpectrum(std::array<float, numPoints>& dest)
+{
+    if ((middleState.load(std::memory_order_acquire) & newDataBit) == 0)
+        return false;
+
+    frontIndex = middleState.exchange(frontIndex, std::memory_order_acq_rel) & ~newDataBit;
+    dest = buffers[(size_t)frontIndex];
+    return true;
+}
+
+void SpectrumAnalyser::run()
+{
+    while (!threadShouldExit())
+    {
+        // Pull everything the audio thread has handed over
+        const auto scope = fifo.read(fifo.getNumReady());
+
+        auto consume = [&](int start, int size)
+        {
+            for (int i = 0; i < size; ++i)
+            {
+                // Slide the analysis window one hop at a time
+                int pos = fftSize - hopSize + samplesSinceLastFrame;
+                timeDomain[(size_t)pos] = fifoBuffer[(size_t)(start + i)];
+
+                if (++samplesSinceLastFrame == hopSize)
+                {
+                    analyseFrame();
+                    std::move(timeDomain.begin() + hopSize, timeDomain.end(), timeDomain.begin());
+                    samplesSinceLastFrame = 0;
+                }
+            }
+        };
+
+        consume(scope.startIndex1, scope.blockSize1);
+        consume(scope.startIndex2, scope.blockSize2);
+
+        wait(15);
+    }
+}
+
+void SpectrumAnalyser::analyseFrame()
+{
+    std::copy(timeDomain.begin(), timeDomain.end(), fftData.begin());
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+
+    window.multiplyWithWindowingTable(fftData.data(), (size_t)fftSize);
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    auto sampleRate = sampleRateForAnalysis.load();
+    auto binWidth = (float)(sampleRate / fftSize);
+    auto normalisation = 4.0f / (float)fftSize;   // Hann coherent gain + one-sided
+
+    auto& back = buffers[(size_t)backIndex];
+
+    for (int p = 0; p < numPoints; ++p)
+    {
+        auto freq = getFrequencyForPoint(p);
+        auto bin = juce::jlimit(1, fftSize / 2 - 1, juce::roundToInt(freq / binWidth));
+        auto db = juce::Decibels::gainToDecibels(fftData[(size_t)bin] * normalisation, floorDb);
+
+        // Fast attack, slow decay
+        auto& s = smoothed[(size_t)p];
+        s = db > s ? db : s + (db - s) * 0.15f;
+        back[(size_t)p] = s;
+    }
+
+    backIndex = middleState.exchange(backIndex | newDataBit, std::memory_order_acq_rel) & ~newDataBit;
+}
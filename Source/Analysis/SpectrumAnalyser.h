@@ -0,0 +1,75 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+// Sidechain spectrum analyser.
+//
+// The audio thread hands mono key samples over through a wait-free FIFO.
+// A background thread runs the windowed FFT, maps bins onto a log-frequency
+// grid, smooths the result and publishes it through a triple buffer, so the
+// FFT never runs on the audio or message thread.
+class SpectrumAnalyser : private juce::Thread
+{
+public:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int numPoints = 256;
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr float floorDb = -100.0f;
+
+    SpectrumAnalyser();
+    ~SpectrumAnalyser() override;
+
+    void prepare(double sampleRate);
+
+    // Start/stop the background thread (message thread). While inactive the
+    // audio thread push is a single atomic load.
+    void setActive(bool shouldBeActive);
+
+    // Audio thread: wait-free, drops samples if the analyser falls behind
+    void pushSamples(const float* left, const float* right, int numSamples) noexcept;
+
+    // Message thread: copies the most recent spectrum (dB per point).
+    // Returns false if nothing new has been published since the last call.
+    bool getLatestSpectrum(std::array<float, numPoints>& dest);
+
+    // Frequency of display point i (log spaced between min and max)
+    static float getFrequencyForPoint(int index)
+    {
+        return minFrequency * std::pow(maxFrequency / minFrequency, index / (float)(numPoints - 1));
+    }
+
+    double getSampleRate() const { return sampleRateForAnalysis.load(); }
+
+private:
+    void run() override;
+    void analyseFrame();
+
+    // Audio -> analyser handoff
+    static constexpr int fifoSize = 1 << 15;
+    juce::AbstractFifo fifo { fifoSize };
+    std::vector<float> fifoBuffer;
+    std::atomic<bool> active { false };
+    std::atomic<double> sampleRateForAnalysis { 44100.0 };
+
+    // Analyser thread state
+    juce::dsp::FFT fft { fftOrder };
+    juce::dsp::WindowingFunction<float> window { (size_t)fftSize, juce::dsp::WindowingFunction<float>::hann };
+    std::vector<float> timeDomain;     // sliding window of the last fftSize samples
+    std::vector<float> fftData;        // 2 * fftSize work buffer
+    std::array<float, numPoints> smoothed {};
+    int samplesSinceLastFrame = 0;
+    static constexpr int hopSize = fftSize / 4;
+
+    // Triple buffer: the writer fills 'back', then swaps it with 'middle';
+    // the reader swaps 'middle' with 'front' when the new-data bit is set.
+    std::array<std::array<float, numPoints>, 3> buffers {};
+    int backIndex = 0;
+    int frontIndex = 1;
+    std::atomic<int> middleState { 2 };
+    static constexpr int newDataBit = 4;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyser)
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <cmath>
 
 namespace DSPUtils
@@ -110,4 +111,14 @@ namespace DSPUtils
                 return value;
         }
     }
+
+    // Tempo sync divisions, in beats:
+    // 1/64, 1/32, 1/16T, 1/16, 1/8T, 1/8, 1/4T, 1/4, 1/2, 1 Bar
+    constexpr int numSyncDivisions = 10;
+
+    inline float getSyncDivisionBeats(int index)
+    {
+        const float divisions[numSyncDivisions] = { 0.0625f, 0.125f, 0.167f, 0.25f, 0.333f, 0.5f, 0.667f, 1.0f, 2.0f, 4.0f };
+        return divisions[std::clamp(index, 0, numSyncDivisions - 1)];
+    }
 }
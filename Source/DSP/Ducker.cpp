@@ -13,8 +13,9 @@ void Ducker::prepare(double sampleRate, int samplesPerBlock)
     envelopeGenerator.prepare(sampleRate, samplesPerBlock);
     sidechainProcessor.prepare(sampleRate, samplesPerBlock);
 
-    // Initialize look-ahead delay lines (max 20ms at sample rate)
-    int maxDelaySamples = static_cast<int>(0.02 * sampleRate) + 1;
+    // Initialize look-ahead delay lines (max 20ms at sample rate, plus one
+    // block of extra delay)
+    int maxDelaySamples = static_cast<int>(0.02 * sampleRate) + samplesPerBlock + 1;
     delayLineL.resize(maxDelaySamples, 0.0f);
     delayLineR.resize(maxDelaySamples, 0.0f);
 
@@ -35,14 +36,25 @@ void Ducker::reset()
     lastSampleL = lastSampleR = 0.0f;
     pendingGainL = pendingGainR = 1.0f;
     targetGain = 1.0f;
+
+    telemetry.discardPending();
+    resetPendingFrame();
 }
 
-void Ducker::process(juce::AudioBuffer<float>& mainBuffer, const juce::AudioBuffer<float>& sidechainBuffer)
+void Ducker::process(juce::AudioBuffer<float>& mainBuffer, const juce::AudioBuffer<float>& sidechainBuffer,
+                     float* appliedGain, float* envelopeOut, const float* envelopeIn)
 {
+    auto numSamples = mainBuffer.getNumSamples();
+
     if (bypassed)
+    {
+        if (appliedGain != nullptr)
+            juce::FloatVectorOperations::fill(appliedGain, 1.0f, numSamples);
+        if (envelopeOut != nullptr)
+            juce::FloatVectorOperations::clear(envelopeOut, numSamples);
         return;
+    }
 
-    auto numSamples = mainBuffer.getNumSamples();
     auto numChannels = mainBuffer.getNumChannels();
 
     auto* mainL = mainBuffer.getWritePointer(0);
@@ -60,15 +72,37 @@ void Ducker::process(juce::AudioBuffer<float>& mainBuffer, const juce::AudioBuff
 
     for (int i = 0; i < numSamples; ++i)
     {
+        // Stage timing on a subset of samples (compiled out by default)
+        const bool timed = profiler.isSampled(i);
+        if (timed)
+            profiler.start();
+
         // Sum sidechain to mono and process through filters
         float scInput = scL[i];
         if (scR != nullptr)
             scInput = (scInput + scR[i]) * 0.5f;
 
-        float filteredSC = sidechainProcessor.processSample(scInput);
+        float filteredSC = scInput;
+        float envelope = 0.0f;
 
-        // Get envelope from sidechain
-        float envelope = envelopeGenerator.processSample(filteredSC);
+        if (envelopeIn != nullptr)
+        {
+            // Detection already ran in the bus sender
+            envelope = envelopeIn[i];
+        }
+        else
+        {
+            filteredSC = sidechainProcessor.processSample(scInput);
+
+            if (timed)
+                profiler.lap(StageProfiling::sidechainFilter);
+
+            // Get envelope from sidechain
+            envelope = envelopeGenerator.processSample(filteredSC);
+        }
+
+        if (envelopeOut != nullptr)
+            envelopeOut[i] = envelope;
 
         // Calculate gain reduction
         // envelope goes 0->1 as sidechain triggers
@@ -82,6 +116,9 @@ void Ducker::process(juce::AudioBuffer<float>& mainBuffer, const juce::AudioBuff
 
         float gain = targetGain;
 
+        if (timed)
+            profiler.lap(StageProfiling::detection);
+
         // Zero-crossing detection for click-free ducking
         if (zeroCrossingEnabled)
         {
@@ -109,6 +146,21 @@ void Ducker::process(juce::AudioBuffer<float>& mainBuffer, const juce::AudioBuff
             pendingGainL = pendingGainR = gain;
         }
 
+        if (timed)
+            profiler.lap(StageProfiling::zeroCrossing);
+
+        float inputMin = mainL[i];
+        float inputMax = mainL[i];
+        if (mainR)
+        {
+            inputMin = std::min(inputMin, mainR[i]);
+            inputMax = std::max(inputMax, mainR[i]);
+        }
+        float inputPeak = std::max(-inputMin, inputMax);
+
+        if (timed)
+            profiler.lap(StageProfiling::metering);
+
         // Write to delay line (for look-ahead)
         delayLineL[delayWritePos] = mainL[i];
         if (mainR)
@@ -130,6 +182,9 @@ void Ducker::process(juce::AudioBuffer<float>& mainBuffer, const juce::AudioBuff
         if (mainR)
             mainR[i] = dryR * dryMix + wetR * wetMix;
 
+        if (appliedGain != nullptr)
+            appliedGain[i] = dryMix + pendingGainL * wetMix;
+
         // Sidechain listen mode - replace output with filtered sidechain
         if (sidechainListen)
         {
@@ -141,14 +196,48 @@ void Ducker::process(juce::AudioBuffer<float>& mainBuffer, const juce::AudioBuff
         // Update write position
         delayWritePos = (delayWritePos + 1) % static_cast<int>(delayLineL.size());
 
+        if (timed)
+            profiler.lap(StageProfiling::delayLine);
+
         // Track gain reduction for metering
         float grDb = DSPUtils::linearToDecibels(gain);
         maxGainReduction = std::max(maxGainReduction, -grDb);
+
+        // Accumulate telemetry for the current sub-block
+        float outputPeak = std::abs(mainL[i]);
+        if (mainR)
+            outputPeak = std::max(outputPeak, std::abs(mainR[i]));
+
+        pendingFrame.envelopeMin = std::min(pendingFrame.envelopeMin, envelope);
+        pendingFrame.envelopeMax = std::max(pendingFrame.envelopeMax, envelope);
+        pendingFrame.gainReductionDb = std::max(pendingFrame.gainReductionDb, -grDb);
+        pendingFrame.inputLevel = std::max(pendingFrame.inputLevel, inputPeak);
+        pendingFrame.outputLevel = std::max(pendingFrame.outputLevel, outputPeak);
+        pendingFrame.triggered = pendingFrame.triggered
+                                 || (envelopeIn != nullptr ? envelope > 0.0f : envelopeGenerator.isTriggered());
+        pendingFrame.keyMin = std::min(pendingFrame.keyMin, scInput);
+        pendingFrame.keyMax = std::max(pendingFrame.keyMax, scInput);
+        pendingFrame.mainMin = std::min(pendingFrame.mainMin, inputMin);
+        pendingFrame.mainMax = std::max(pendingFrame.mainMax, inputMax);
+        pendingFrame.gainMin = std::min(pendingFrame.gainMin, gain);
+        pendingFrame.gainMax = std::max(pendingFrame.gainMax, gain);
+
+        if (++pendingFrame.numSamples >= telemetryBlockSize)
+            publishTelemetry();
+
+        if (timed)
+            profiler.lap(StageProfiling::metering);
     }
 
     currentGainReduction = maxGainReduction;
 }
 
+void Ducker::applyGainCurve(juce::AudioBuffer<float>& buffer, const float* gain, int startSample, int numSamples)
+{
+    for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        juce::FloatVectorOperations::multiply(buffer.getWritePointer(ch, startSample), gain, numSamples);
+}
+
 float Ducker::processSample(float input, float sidechainInput)
 {
     // Filter sidechain
@@ -206,6 +295,12 @@ void Ducker::setLookAhead(float ms)
     updateLookAhead();
 }
 
+void Ducker::setExtraDelay(int samples)
+{
+    extraDelaySamples = juce::jlimit(0, currentBlockSize, samples);
+    updateLookAhead();
+}
+
 void Ducker::setCurveShape(int shapeIndex)
 {
     curveShape = static_cast<DSPUtils::CurveShape>(shapeIndex);
@@ -252,7 +347,31 @@ void Ducker::setZeroCrossingEnabled(bool enabled)
     zeroCrossingEnabled = enabled;
 }
 
+void Ducker::publishTelemetry()
+{
+    if (pendingFrame.triggered && !lastFrameTriggered)
+        ++counters.triggers;
+    lastFrameTriggered = pendingFrame.triggered;
+
+    if (pendingFrame.gainReductionDb > 0.1f)
+        counters.duckedSamples += (juce::uint64)pendingFrame.numSamples;
+
+    telemetry.push(pendingFrame);
+    resetPendingFrame();
+}
+
+void Ducker::resetPendingFrame()
+{
+    // Min fields start at their upper bound so the first sample sets them
+    pendingFrame = {};
+    pendingFrame.envelopeMin = 1.0f;
+    pendingFrame.gainMax = 0.0f;
+    pendingFrame.keyMin = pendingFrame.mainMin = std::numeric_limits<float>::max();
+    pendingFrame.keyMax = pendingFrame.mainMax = std::numeric_limits<float>::lowest();
+}
+
 void Ducker::updateLookAhead()
 {
-    lookAheadSamples = static_cast<int>(lookAheadMs * 0.001f * currentSampleRate);
+    lookAheadSamples = static_cast<int>(lookAheadMs * 0.001f * currentSampleRate)
+                     + std::min(extraDelaySamples, currentBlockSize);
 }
@@ -1,9 +1,11 @@
 #pragma once
 
-#include <JuceHeader.h>
+#include <juce_audio_basics/juce_audio_basics.h>
 #include "DSPUtils.h"
 #include "EnvelopeGenerator.h"
 #include "SidechainProcessor.h"
+#include "StageProfiler.h"
+#include "Telemetry.h"
 
 class Ducker
 {
@@ -11,7 +13,19 @@ public:
     Ducker();
 
     void prepare(double sampleRate, int samplesPerBlock);
-    void process(juce::AudioBuffer<float>& mainBuffer, const juce::AudioBuffer<float>& sidechainBuffer);
+    // If appliedGain is given it receives, per output sample, the gain that
+    // was applied to the delayed main signal (mix included) - the detection
+    // result as a gain track that applyGainCurve() can replay later.
+    // envelopeOut, if given, receives the detector envelope (0..1) per input
+    // sample. envelopeIn, if given, replaces sidechain filtering and detection
+    // with a precomputed envelope (EnvelopeBus receivers); the sidechain
+    // buffer then only feeds metering and listen mode.
+    void process(juce::AudioBuffer<float>& mainBuffer, const juce::AudioBuffer<float>& sidechainBuffer,
+                 float* appliedGain = nullptr, float* envelopeOut = nullptr, const float* envelopeIn = nullptr);
+
+    // Replay stage: multiply every channel by a precomputed gain track,
+    // with no sidechain filtering, detection or look-ahead delay.
+    static void applyGainCurve(juce::AudioBuffer<float>& buffer, const float* gain, int startSample, int numSamples);
     void reset();
 
     // Parameter setters
@@ -22,6 +36,9 @@ public:
     void setRelease(float releaseMs);
     void setRange(float rangeDb);
     void setLookAhead(float lookAheadMs);
+    // Delay of the main path on top of look-ahead, up to one block (bus
+    // receivers reading the envelope a block late). Included in the latency.
+    void setExtraDelay(int samples);
     void setCurveShape(int shapeIndex);
     void setMix(float mixPercent);
     void setBypass(bool shouldBypass);
@@ -36,18 +53,37 @@ public:
     // Zero-crossing option
     void setZeroCrossingEnabled(bool enabled);
 
-    // Getters for metering/visualization
+    // Getters for metering/visualization (audio thread only - the editor
+    // should read the telemetry FIFO instead)
     float getGainReduction() const { return currentGainReduction; }
     float getEnvelopeValue() const { return envelopeGenerator.getCurrentEnvelope(); }
     bool isTriggered() const { return envelopeGenerator.isTriggered(); }
     bool isSidechainListening() const { return sidechainListen; }
 
+    // Per-sub-block telemetry published for the editor
+    TelemetryFifo& getTelemetry() { return telemetry; }
+
+    // Lifetime totals for the live stats endpoint, counted per telemetry
+    // frame (so at telemetryBlockSize resolution). reset() keeps them.
+    struct Counters
+    {
+        juce::uint64 triggers = 0;        // rising edges of the trigger
+        juce::uint64 duckedSamples = 0;   // samples with gain reduction applied
+    };
+    const Counters& getCounters() const { return counters; }
+
+    // Per-stage timing (profiling builds). process() laps its own stages;
+    // the caller brackets the block with beginBlock()/endBlock().
+    StageProfiling::Profiler& getProfiler() { return profiler; }
+
     // Get latency in samples (for look-ahead)
     int getLatencyInSamples() const { return lookAheadSamples; }
 
 private:
     float processSample(float input, float sidechainInput);
     void updateLookAhead();
+    void publishTelemetry();
+    void resetPendingFrame();
 
     // DSP Modules
     EnvelopeGenerator envelopeGenerator;
@@ -75,6 +111,7 @@ private:
     std::vector<float> delayLineR;
     int delayWritePos = 0;
     int lookAheadSamples = 0;
+    int extraDelaySamples = 0;
 
     // Zero-crossing state
     float lastSampleL = 0.0f;
@@ -83,6 +120,15 @@ private:
     float pendingGainR = 1.0f;
     float targetGain = 1.0f;
 
+    // Telemetry accumulation (one frame per telemetryBlockSize samples)
+    static constexpr int telemetryBlockSize = 64;
+    TelemetryFifo telemetry;
+    TelemetryFrame pendingFrame;
+    Counters counters;
+    bool lastFrameTriggered = false;
+
+    StageProfiling::Profiler profiler;
+
     // Runtime
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
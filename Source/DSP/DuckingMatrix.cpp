@@ -0,0 +1,246 @@
+#include "DuckingMatrix.h"
+
+void DuckingMatrix::prepare(double newSampleRate, int newMaxBlockSize, int newNumKeys, int newNumTargets)
+{
+    sampleRate = newSampleRate;
+    maxBlockSize = juce::jmax(1, newMaxBlockSize);
+    numKeys = juce::jlimit(0, maxKeys, newNumKeys);
+    numTargets = juce::jlimit(0, maxTargets, newNumTargets);
+
+    keyScratch.assign((size_t)(maxKeys * maxBlockSize), 0.0f);
+    gainScratch.assign((size_t)(maxTargets * maxBlockSize), 1.0f);
+
+    // Look-ahead delay lines (max 20ms at sample rate)
+    for (auto& line : delayLines)
+        line.setSize(maxChannelsPerTarget, static_cast<int>(0.02 * sampleRate) + 1);
+
+    for (int k = 0; k < maxKeys; ++k)
+    {
+        filters[(size_t)k].prepare(sampleRate, maxBlockSize);
+        updateKeyCoefficients(k);
+    }
+
+    for (int t = 0; t < maxTargets; ++t)
+        updateReductions(t);
+
+    setLookAhead(lookAheadMs);
+    reset();
+}
+
+void DuckingMatrix::reset()
+{
+    for (auto& filter : filters)
+        filter.reset();
+
+    envelope.fill(0.0f);
+    holdCounter.fill(0);
+    state.fill(idle);
+
+    for (auto& line : delayLines)
+        line.clear();
+    delayWritePos.fill(0);
+}
+
+void DuckingMatrix::setKey(int key, const KeySettings& settings)
+{
+    if (!juce::isPositiveAndBelow(key, maxKeys))
+        return;
+
+    keySettings[(size_t)key] = settings;
+    updateKeyCoefficients(key);
+}
+
+void DuckingMatrix::setTarget(int target, const TargetSettings& settings)
+{
+    if (!juce::isPositiveAndBelow(target, maxTargets))
+        return;
+
+    targetSettings[(size_t)target] = settings;
+    updateReductions(target);
+}
+
+void DuckingMatrix::setDepth(int key, int target, float newDepthDb)
+{
+    if (!juce::isPositiveAndBelow(key, maxKeys) || !juce::isPositiveAndBelow(target, maxTargets))
+        return;
+
+    depthDb[(size_t)key][(size_t)target] = juce::jmin(0.0f, newDepthDb);
+    updateReductions(target);
+}
+
+void DuckingMatrix::setLookAhead(float ms)
+{
+    lookAheadMs = ms;
+    lookAheadSamples = juce::jlimit(0, delayLines[0].getNumSamples() - 1,
+                                    static_cast<int>(lookAheadMs * 0.001f * sampleRate));
+}
+
+void DuckingMatrix::updateKeyCoefficients(int key)
+{
+    const auto k = (size_t)key;
+    const auto& s = keySettings[k];
+
+    // Unused lanes never trigger
+    threshold[k] = key < numKeys ? DSPUtils::decibelsToLinear(s.threshold) : std::numeric_limits<float>::max();
+    attackCoeff[k] = DSPUtils::calculateCoefficient(sampleRate, s.attack);
+    releaseCoeff[k] = DSPUtils::calculateCoefficient(sampleRate, s.release);
+    holdSamples[k] = static_cast<int>(s.hold * 0.001f * sampleRate);
+
+    auto& filter = filters[k];
+    filter.setHighPassFreq(s.hpfFreq);
+    filter.setLowPassFreq(s.lpfFreq);
+    filter.setHighPassEnabled(s.hpfEnabled);
+    filter.setLowPassEnabled(s.lpfEnabled);
+}
+
+void DuckingMatrix::updateReductions(int target)
+{
+    const auto t = (size_t)target;
+    const auto floorGain = DSPUtils::decibelsToLinear(targetSettings[t].range);
+
+    for (size_t k = 0; k < (size_t)maxKeys; ++k)
+    {
+        const auto cell = depthDb[k][t];
+        reduction[k][t] = (cell < 0.0f && (int)k < numKeys && target < numTargets)
+                              ? 1.0f - juce::jmax(DSPUtils::decibelsToLinear(cell), floorGain)
+                              : 0.0f;
+    }
+
+    wetMix[t] = targetSettings[t].mix / 100.0f;
+}
+
+void DuckingMatrix::process(const float* const* keys, juce::AudioBuffer<float>* const* targets, int numSamples,
+                            float* const* targetGains)
+{
+    // Callers must split wider targets; the delay lines stop at this
+    for (int t = 0; t < numTargets; ++t)
+        jassert(targets[t]->getNumChannels() <= maxChannelsPerTarget);
+
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize)
+        processChunk(keys, targets, offset, juce::jmin(maxBlockSize, numSamples - offset), targetGains);
+}
+
+void DuckingMatrix::processChunk(const float* const* keys, juce::AudioBuffer<float>* const* targets,
+                                 int offset, int numSamples, float* const* targetGains)
+{
+    // Filter and rectify each key; unused lanes stay at zero
+    for (int k = 0; k < numKeys; ++k)
+    {
+        auto& filter = filters[(size_t)k];
+        const float* key = keys[k] + offset;
+        float* lanes = keyScratch.data() + k;
+
+        for (int i = 0; i < numSamples; ++i)
+            lanes[i * maxKeys] = std::abs(filter.processSample(key[i]));
+    }
+
+    // Detection: EnvelopeGenerator's state machine, branch-free across lanes
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float* lanes = keyScratch.data() + i * maxKeys;
+
+        for (int l = 0; l < maxKeys; ++l)
+        {
+            const bool trigger = lanes[l] > threshold[(size_t)l];
+            int st = state[(size_t)l];
+            int counter = trigger ? holdSamples[(size_t)l] : holdCounter[(size_t)l];
+            const float env = envelope[(size_t)l];
+
+            st = (trigger && (st == idle || st == release)) ? (int)attack : st;
+
+            const float attacked = env + attackCoeff[(size_t)l] * (1.0f - env);
+            const float released = env - releaseCoeff[(size_t)l] * env;
+            const bool attackDone = attacked >= 0.999f;
+            const bool releaseDone = released < 0.001f;
+            const bool inAttack = st == attack, inHold = st == hold, inRelease = st == release;
+
+            counter = inHold ? counter - 1 : counter;
+
+            const float next = inAttack    ? (attackDone ? 1.0f : attacked)
+                             : inHold      ? 1.0f
+                             : inRelease   ? (releaseDone ? 0.0f : released)
+                                           : 0.0f;
+
+            st = inAttack    ? (attackDone ? (int)hold : (int)attack)
+               : inHold      ? ((counter <= 0 && !trigger) ? (int)release : (int)hold)
+               : inRelease   ? (releaseDone ? (int)idle : (int)release)
+                             : (int)idle;
+
+            envelope[(size_t)l] = next;
+            holdCounter[(size_t)l] = counter;
+            state[(size_t)l] = st;
+            lanes[l] = next;
+        }
+    }
+
+    // Curve shape per key, with the switch outside the sample loop
+    for (int k = 0; k < numKeys; ++k)
+    {
+        float* lanes = keyScratch.data() + k;
+        const auto shape = static_cast<DSPUtils::CurveShape>(keySettings[(size_t)k].curveShape);
+
+        if (shape == DSPUtils::CurveShape::Linear)
+            continue;
+
+        for (int i = 0; i < numSamples; ++i)
+            lanes[i * maxKeys] = DSPUtils::applyCurveShape(lanes[i * maxKeys], shape);
+    }
+
+    // Combine: per target, the deepest of its cells' gains, then mix
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float* env = keyScratch.data() + i * maxKeys;
+        float* gains = gainScratch.data() + i * maxTargets;
+
+        alignas(32) float g[maxTargets];
+        for (int t = 0; t < maxTargets; ++t)
+            g[t] = 1.0f;
+
+        for (int k = 0; k < numKeys; ++k)
+        {
+            const float e = env[k];
+            const auto& cells = reduction[(size_t)k];
+            for (int t = 0; t < maxTargets; ++t)
+                g[t] = std::min(g[t], 1.0f - cells[(size_t)t] * e);
+        }
+
+        for (int t = 0; t < maxTargets; ++t)
+            gains[t] = 1.0f - wetMix[(size_t)t] + wetMix[(size_t)t] * g[t];
+    }
+
+    // Apply each target's gain to its look-ahead-delayed channels
+    for (int t = 0; t < numTargets; ++t)
+    {
+        auto& target = *targets[t];
+        auto& line = delayLines[(size_t)t];
+        const int lineLength = line.getNumSamples();
+        const int numChannels = juce::jmin(target.getNumChannels(), maxChannelsPerTarget);
+        const float* gains = gainScratch.data() + t;
+        const int startPos = delayWritePos[(size_t)t];
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            float* audio = target.getWritePointer(ch, offset);
+            float* delay = line.getWritePointer(ch);
+            int writePos = startPos;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                delay[writePos] = audio[i];
+
+                int readPos = writePos - lookAheadSamples;
+                if (readPos < 0)
+                    readPos += lineLength;
+
+                audio[i] = delay[readPos] * gains[i * maxTargets];
+                writePos = writePos + 1 == lineLength ? 0 : writePos + 1;
+            }
+        }
+
+        delayWritePos[(size_t)t] = (startPos + numSamples) % lineLength;
+
+        if (targetGains != nullptr && targetGains[t] != nullptr)
+            for (int i = 0; i < numSamples; ++i)
+                targetGains[t][offset + i] = gains[i * maxTargets];
+    }
+}
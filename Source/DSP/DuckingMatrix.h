@@ -0,0 +1,113 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <limits>
+#include <vector>
+#include "DSPUtils.h"
+#include "SidechainProcessor.h"
+
+// Many keys ducking many targets in one processor.
+//
+// Each key (a mono sidechain signal) is filtered and detected once. Each
+// target (a group of channels, e.g. the music stem) gets one gain per sample
+// from the cells of its column: a cell's depth scales its key's envelope,
+// and when several keys duck the same target at once, the deepest reduction
+// wins. The result is floored at the target's range, mixed, and applied to
+// the target's channels after the shared look-ahead delay.
+//
+// Detection runs as a structure-of-arrays over maxKeys lanes with a
+// branch-free form of EnvelopeGenerator's state machine, and the gain
+// combine as an M x maxTargets multiply-min. Both inner loops have fixed trip
+// counts over contiguous arrays, so the compiler vectorises them; unused
+// lanes never trigger and have zero depth. The per-sample cost is close to
+// that of one or two Ducker instances regardless of how many cells are set.
+//
+// Used by the Ducker Matrix plugin (Source/Matrix) and ducker_matrix.
+class DuckingMatrix
+{
+public:
+    static constexpr int maxKeys = 8;
+    static constexpr int maxTargets = 8;
+    static constexpr int maxChannelsPerTarget = 8;
+
+    struct KeySettings
+    {
+        float threshold = -20.0f;      // dB
+        float attack = 10.0f;          // ms
+        float hold = 50.0f;            // ms
+        float release = 200.0f;        // ms
+        int curveShape = 0;
+        bool hpfEnabled = false;
+        bool lpfEnabled = false;
+        float hpfFreq = 80.0f;         // Hz
+        float lpfFreq = 12000.0f;      // Hz
+    };
+
+    struct TargetSettings
+    {
+        float range = -40.0f;          // dB floor
+        float mix = 100.0f;            // %
+    };
+
+    void prepare(double sampleRate, int maxBlockSize, int numKeys, int numTargets);
+    void reset();
+
+    void setKey(int key, const KeySettings& settings);
+    void setTarget(int target, const TargetSettings& settings);
+    // Depth of key -> target ducking in dB (0: the key does not duck it)
+    void setDepth(int key, int target, float depthDb);
+    void setLookAhead(float lookAheadMs);
+
+    int getNumKeys() const { return numKeys; }
+    int getNumTargets() const { return numTargets; }
+    int getLatencyInSamples() const { return lookAheadSamples; }
+
+    // keys[k] are mono key signals; targets[t] are processed in place, with
+    // at most maxChannelsPerTarget channels (any further ones are left
+    // untouched: neither delayed nor ducked). targetGains[t], if given,
+    // receive the applied gains.
+    void process(const float* const* keys, juce::AudioBuffer<float>* const* targets, int numSamples,
+                 float* const* targetGains = nullptr);
+
+private:
+    void processChunk(const float* const* keys, juce::AudioBuffer<float>* const* targets,
+                      int offset, int numSamples, float* const* targetGains);
+    void updateKeyCoefficients(int key);
+    void updateReductions(int target);
+
+    enum State : int { idle, attack, hold, release };
+
+    double sampleRate = 44100.0;
+    int maxBlockSize = 512;
+    int numKeys = 0, numTargets = 0;
+
+    // Key lanes (structure of arrays)
+    std::array<KeySettings, maxKeys> keySettings {};
+    std::array<SidechainProcessor, maxKeys> filters;
+    alignas(32) std::array<float, maxKeys> threshold {};
+    alignas(32) std::array<float, maxKeys> attackCoeff {};
+    alignas(32) std::array<float, maxKeys> releaseCoeff {};
+    alignas(32) std::array<int, maxKeys> holdSamples {};
+    alignas(32) std::array<float, maxKeys> envelope {};
+    alignas(32) std::array<int, maxKeys> holdCounter {};
+    alignas(32) std::array<int, maxKeys> state {};
+
+    // Cells: depthDb as set, and the linear reduction at full envelope with
+    // the target's range floor folded in (as Ducker's duckedGain)
+    std::array<std::array<float, maxTargets>, maxKeys> depthDb {};
+    alignas(32) std::array<std::array<float, maxTargets>, maxKeys> reduction {};
+    std::array<TargetSettings, maxTargets> targetSettings {};
+    alignas(32) std::array<float, maxTargets> wetMix {};
+
+    // Per-chunk scratch, sample-major so each sample's lanes are contiguous:
+    // filtered |key| then shaped envelope [i * maxKeys + k], gains [i * maxTargets + t]
+    std::vector<float> keyScratch;
+    std::vector<float> gainScratch;
+
+    // Look-ahead delay per target, one line per channel
+    std::array<juce::AudioBuffer<float>, maxTargets> delayLines;
+    std::array<int, maxTargets> delayWritePos {};
+    float lookAheadMs = 5.0f;
+    int lookAheadSamples = 0;
+};
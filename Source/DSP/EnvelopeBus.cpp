@@ -0,0 +1,82 @@
+#include "EnvelopeBus.h"
+
+namespace EnvelopeBus
+{
+    static constexpr juce::int64 mask = Channel::capacity - 1;
+
+    Channel::Channel() : ring(new std::atomic<float>[(size_t)capacity])
+    {
+        for (int i = 0; i < capacity; ++i)
+            ring[(size_t)i].store(0.0f, std::memory_order_relaxed);
+    }
+
+    void Channel::write(juce::int64 position, const float* envelope, int numSamples) noexcept
+    {
+        if (position != end.load(std::memory_order_relaxed))
+        {
+            generation.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            start.store(position, std::memory_order_relaxed);
+            end.store(position, std::memory_order_relaxed);
+            generation.fetch_add(1, std::memory_order_release);
+        }
+
+        for (int i = 0; i < numSamples; ++i)
+            ring[(size_t)((position + i) & mask)].store(envelope[i], std::memory_order_relaxed);
+
+        end.store(position + numSamples, std::memory_order_release);
+    }
+
+    bool Channel::read(juce::int64 position, float* envelope, int numSamples) const noexcept
+    {
+        auto before = generation.load(std::memory_order_acquire);
+        if ((before & 1) != 0)
+            return false;
+
+        auto first = start.load(std::memory_order_acquire);
+        auto last = end.load(std::memory_order_acquire);
+
+        if (position < first || position + numSamples > last || position < last - window)
+            return false;
+
+        for (int i = 0; i < numSamples; ++i)
+            envelope[i] = ring[(size_t)((position + i) & mask)].load(std::memory_order_relaxed);
+
+        // Reject the copy if a new range started or the writer lapped it
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return generation.load(std::memory_order_relaxed) == before
+            && position >= end.load(std::memory_order_relaxed) - window;
+    }
+
+    bool Channel::claimSender() noexcept
+    {
+        bool expected = false;
+        return hasSender.compare_exchange_strong(expected, true);
+    }
+
+    void Channel::releaseSender() noexcept
+    {
+        hasSender.store(false);
+    }
+
+    //==============================================================================
+    Channel* Registry::getChannel(const juce::String& name)
+    {
+        auto key = name.trim().substring(0, maxNameLength);
+        if (key.isEmpty())
+            return nullptr;
+
+        const juce::ScopedLock sl(lock);
+
+        for (int i = 0; i < numChannels; ++i)
+            if (names[(size_t)i] == key)
+                return channels[(size_t)i].get();
+
+        if (numChannels == maxChannels)
+            return nullptr;
+
+        names[(size_t)numChannels] = key;
+        channels[(size_t)numChannels] = std::make_unique<Channel>();
+        return channels[(size_t)numChannels++].get();
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <memory>
+
+// Process-wide envelope broadcast between Ducker instances.
+//
+// One "send" instance runs its sidechain filters and detector as usual and
+// writes the resulting envelope (0..1 per sample) to a named Channel. Any
+// number of "receive" instances read it instead of running their own
+// detection; threshold, timing and filters come from the sender, depth,
+// range, mix, look-ahead and zero-crossing stay per receiver.
+//
+// The channel is a ring indexed by timeline sample position, written
+// wait-free by the sender and read wait-free by receivers (seqlock-style:
+// a reader validates after copying that the range was neither reset nor
+// overwritten). Because the host may run a receiver before its sender in the
+// same cycle, receivers read one block in the past and delay their own audio
+// by that block too, reporting it as latency; after delay compensation the
+// result is sample-aligned with a routed sidechain.
+namespace EnvelopeBus
+{
+    constexpr int maxNameLength = 31;
+
+    class Channel
+    {
+    public:
+        static constexpr int capacity = 1 << 15;    // samples, power of two
+        static constexpr int window = capacity / 2; // readable history
+
+        Channel();
+
+        // Sender (audio thread). A position that doesn't continue the
+        // previous write starts a new range.
+        void write(juce::int64 position, const float* envelope, int numSamples) noexcept;
+
+        // Receivers (audio thread): copies [position, position + numSamples),
+        // false if any of it isn't available
+        bool read(juce::int64 position, float* envelope, int numSamples) const noexcept;
+
+        // End of the written range, for receivers without a host timeline
+        juce::int64 getWriteEnd() const noexcept { return end.load(std::memory_order_acquire); }
+
+        // Message thread: at most one sender per channel
+        bool claimSender() noexcept;
+        void releaseSender() noexcept;
+
+    private:
+        std::unique_ptr<std::atomic<float>[]> ring;
+        std::atomic<juce::uint32> generation { 0 };   // odd while a new range starts
+        std::atomic<juce::int64> start { 0 }, end { 0 };
+        std::atomic<bool> hasSender { false };
+
+        JUCE_DECLARE_NON_COPYABLE(Channel)
+    };
+
+    // Name -> channel table shared by every instance in the process (hold a
+    // juce::SharedResourcePointer<Registry>). Channels are created on first
+    // use and kept for the registry's lifetime, so a pointer handed to the
+    // audio thread never dangles.
+    class Registry
+    {
+    public:
+        static constexpr int maxChannels = 64;
+
+        // Message thread. nullptr for an empty name or a full table.
+        Channel* getChannel(const juce::String& name);
+
+    private:
+        juce::CriticalSection lock;
+        std::array<juce::String, maxChannels> names;
+        std::array<std::unique_ptr<Channel>, maxChannels> channels;
+        int numChannels = 0;
+    };
+}
@@ -83,6 +83,19 @@ float EnvelopeGenerator::processSample(float triggerLevel)
     return DSPUtils::applyCurveShape(currentEnvelope, curveShape);
 }
 
+EnvelopeGenerator::Snapshot EnvelopeGenerator::getSnapshot() const
+{
+    return { static_cast<int>(currentState), currentEnvelope, holdCounter, triggered };
+}
+
+void EnvelopeGenerator::restoreSnapshot(const Snapshot& snapshot)
+{
+    currentState = static_cast<State>(juce::jlimit(0, 3, snapshot.state));
+    currentEnvelope = snapshot.envelope;
+    holdCounter = snapshot.holdCounter;
+    triggered = snapshot.triggered;
+}
+
 void EnvelopeGenerator::setThreshold(float thresholdDb)
 {
     threshold = thresholdDb;
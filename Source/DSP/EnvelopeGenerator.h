@@ -1,6 +1,6 @@
 #pragma once
 
-#include <JuceHeader.h>
+#include <juce_audio_basics/juce_audio_basics.h>
 #include "DSPUtils.h"
 
 class EnvelopeGenerator
@@ -25,6 +25,19 @@ public:
     float getCurrentEnvelope() const { return currentEnvelope; }
     bool isTriggered() const { return triggered; }
 
+    // Complete running state, so detection can resume mid-stream (offline
+    // chunk cache). Parameters are not included.
+    struct Snapshot
+    {
+        int state = 0;
+        float envelope = 0.0f;
+        int holdCounter = 0;
+        bool triggered = false;
+    };
+
+    Snapshot getSnapshot() const;
+    void restoreSnapshot(const Snapshot& snapshot);
+
 private:
     enum class State
     {
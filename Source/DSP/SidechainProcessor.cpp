@@ -120,6 +120,21 @@ void SidechainProcessor::processBuffer(juce::AudioBuffer<float>& buffer)
     }
 }
 
+SidechainProcessor::Snapshot SidechainProcessor::getSnapshot() const
+{
+    return { { hpX1L, hpX2L, hpY1L, hpY2L, hpX1R, hpX2R, hpY1R, hpY2R,
+               lpX1L, lpX2L, lpY1L, lpY2L, lpX1R, lpX2R, lpY1R, lpY2R } };
+}
+
+void SidechainProcessor::restoreSnapshot(const Snapshot& snapshot)
+{
+    const auto& s = snapshot.state;
+    hpX1L = s[0];  hpX2L = s[1];  hpY1L = s[2];  hpY2L = s[3];
+    hpX1R = s[4];  hpX2R = s[5];  hpY1R = s[6];  hpY2R = s[7];
+    lpX1L = s[8];  lpX2L = s[9];  lpY1L = s[10]; lpY2L = s[11];
+    lpX1R = s[12]; lpX2R = s[13]; lpY1R = s[14]; lpY2R = s[15];
+}
+
 void SidechainProcessor::setHighPassFreq(float freq)
 {
     highPassFreq = freq;
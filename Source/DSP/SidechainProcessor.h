@@ -1,6 +1,7 @@
 #pragma once
 
-#include <JuceHeader.h>
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
 #include "DSPUtils.h"
 
 class SidechainProcessor
@@ -26,6 +27,16 @@ public:
     // Getters
     float getFilteredLevel() const { return filteredLevel; }
 
+    // Filter state (x1, x2, y1, y2 for HPF L/R then LPF L/R), so filtering
+    // can resume mid-stream (offline chunk cache)
+    struct Snapshot
+    {
+        std::array<float, 16> state {};
+    };
+
+    Snapshot getSnapshot() const;
+    void restoreSnapshot(const Snapshot& snapshot);
+
 private:
     void updateFilters();
 
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <chrono>
+#include <limits>
+
+#if JUCE_INTEL
+ #if JUCE_MSVC
+  #include <intrin.h>
+ #else
+  #include <x86intrin.h>
+ #endif
+#endif
+
+// Per-stage timing of the audio path (profiling builds).
+//
+// Build with DUCKER_PROFILING=1 (CMake: -DDUCKER_PROFILING=ON). Each block
+// then accumulates time-stamp-counter ticks per stage: parameter updates and
+// the sidechain copy in processBlock, and inside Ducker::process the
+// sidechain filters, detection, zero-crossing gating, delay line/mix and
+// metering. The frame is pushed to a wait-free FIFO at the end of the block
+// and aggregated by the editor's diagnostics panel.
+//
+// The per-sample stages are timed on every sampleStride-th sample only and
+// scaled up. Each of those stages is only a few cycles long, comparable to a
+// (non-serialising) counter read, so their figures are upper bounds: the
+// calibrated cost of one read is subtracted from every lap, but what remains
+// still includes pipeline disturbance around the reads, and their sum can
+// exceed the block total. Use them to compare stages and builds, not as
+// absolute costs; the block total is the reliable number. With
+// DUCKER_PROFILING=0 (the default) every call is an empty inline function
+// and the per-sample branches fold away.
+#ifndef DUCKER_PROFILING
+ #define DUCKER_PROFILING 0
+#endif
+
+namespace StageProfiling
+{
+    constexpr bool enabled = DUCKER_PROFILING != 0;
+    constexpr int sampleStride = 8;
+
+    enum Stage
+    {
+        parameters,
+        sidechainCopy,
+        sidechainFilter,
+        detection,
+        zeroCrossing,
+        delayLine,
+        metering,
+        block,             // all of processBlock
+        numStages
+    };
+
+    inline const char* getStageName(int stage)
+    {
+        const char* names[numStages] = { "Parameters", "SC copy", "SC filter", "Detection",
+                                         "Zero-cross", "Delay/mix", "Metering", "Block total" };
+        return names[juce::jlimit(0, numStages - 1, stage)];
+    }
+
+    // Raw tick counter: the TSC on x86, steady_clock elsewhere
+    inline juce::uint64 now() noexcept
+    {
+       #if JUCE_INTEL
+        return (juce::uint64)__rdtsc();
+       #else
+        return (juce::uint64)std::chrono::steady_clock::now().time_since_epoch().count();
+       #endif
+    }
+
+    struct Frame
+    {
+        std::array<juce::uint64, numStages> ticks {};
+        int numSamples = 0;
+    };
+
+    // Wait-free single-producer/single-consumer ring of frames, as TelemetryFifo
+    class Fifo
+    {
+    public:
+        // A single slot when profiling is compiled out, so the per-instance
+        // footprint doesn't grow
+        static constexpr int capacity = enabled ? 1024 : 1;
+
+        bool push(const Frame& frame) noexcept
+        {
+            const auto scope = fifo.write(1);
+            if (scope.blockSize1 > 0)
+            {
+                frames[(size_t)scope.startIndex1] = frame;
+                return true;
+            }
+            if (scope.blockSize2 > 0)
+            {
+                frames[(size_t)scope.startIndex2] = frame;
+                return true;
+            }
+            return false;
+        }
+
+        template <typename Fn>
+        int drain(Fn&& fn)
+        {
+            const auto scope = fifo.read(fifo.getNumReady());
+            for (int i = 0; i < scope.blockSize1; ++i)
+                fn(frames[(size_t)(scope.startIndex1 + i)]);
+            for (int i = 0; i < scope.blockSize2; ++i)
+                fn(frames[(size_t)(scope.startIndex2 + i)]);
+            return scope.blockSize1 + scope.blockSize2;
+        }
+
+    private:
+        juce::AbstractFifo fifo { capacity };
+        std::array<Frame, capacity> frames {};
+    };
+
+    // Audio-thread side. Laps attribute the ticks since the previous lap
+    // (or start) to a stage, so each boundary costs one counter read.
+    class Profiler
+    {
+    public:
+        Profiler()
+        {
+            if constexpr (enabled)
+            {
+                // Cheapest back-to-back read: the counter's own share of a lap
+                auto cheapest = std::numeric_limits<juce::uint64>::max();
+                for (int i = 0; i < 1000; ++i)
+                {
+                    auto a = now();
+                    cheapest = std::min(cheapest, now() - a);
+                }
+                readOverhead = cheapest;
+            }
+        }
+
+        void beginBlock() noexcept
+        {
+            if constexpr (enabled)
+            {
+                current = {};
+                blockStart = last = now();
+            }
+        }
+
+        // Publishes the block; stages timed per sample are scaled from the
+        // sampled subset to the whole block
+        void endBlock(int numSamples) noexcept
+        {
+            if constexpr (enabled)
+            {
+                current.ticks[block] = now() - blockStart;
+                current.numSamples = numSamples;
+
+                if (sampledCount > 0)
+                {
+                    auto scale = (double)numSamples / sampledCount;
+                    for (int s = sidechainFilter; s <= metering; ++s)
+                        current.ticks[(size_t)s] = (juce::uint64)((double)current.ticks[(size_t)s] * scale);
+                }
+
+                sampledCount = 0;
+                fifo.push(current);
+            }
+        }
+
+        void start() noexcept
+        {
+            if constexpr (enabled)
+                last = now();
+        }
+
+        void lap(Stage stage) noexcept
+        {
+            if constexpr (enabled)
+            {
+                auto t = now();
+                auto elapsed = t - last;
+                current.ticks[(size_t)stage] += elapsed > readOverhead ? elapsed - readOverhead : 0;
+                last = t;
+            }
+        }
+
+        // Per-sample stages: true for the samples that get timed
+        bool isSampled(int sampleIndex) noexcept
+        {
+            if constexpr (enabled)
+            {
+                if (sampleIndex % sampleStride != 0)
+                    return false;
+                ++sampledCount;
+                return true;
+            }
+            else
+            {
+                juce::ignoreUnused(sampleIndex);
+                return false;
+            }
+        }
+
+        Fifo& getFifo() noexcept { return fifo; }
+
+    private:
+        Frame current;
+        juce::uint64 blockStart = 0, last = 0;
+        juce::uint64 readOverhead = 0;
+        int sampledCount = 0;
+        Fifo fifo;
+    };
+
+    // Message-thread conversion of ticks to seconds, measured against the
+    // wall clock since construction
+    class TickRate
+    {
+    public:
+        TickRate() : startTicks(now()), startMs(juce::Time::getMillisecondCounterHiRes()) {}
+
+        // 0 until enough time has passed to measure
+        double getTicksPerSecond()
+        {
+            auto elapsedMs = juce::Time::getMillisecondCounterHiRes() - startMs;
+            if (elapsedMs > 200.0)
+                ticksPerSecond = (double)(now() - startTicks) / (elapsedMs * 0.001);
+            return ticksPerSecond;
+        }
+
+    private:
+        juce::uint64 startTicks;
+        double startMs;
+        double ticksPerSecond = 0.0;
+    };
+}
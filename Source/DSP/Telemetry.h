@@ -0,0 +1,90 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <array>
+#include <atomic>
+
+// One telemetry frame summarises a short sub-block of audio-thread state
+// (min/max envelope, peak gain reduction, trigger flag, levels and the
+// min/max of the key, main and gain signals for the waveform overview).
+struct TelemetryFrame
+{
+    float envelopeMin = 0.0f;
+    float envelopeMax = 0.0f;
+    float gainReductionDb = 0.0f;  // peak GR in this sub-block (positive dB)
+    float inputLevel = 0.0f;       // peak linear
+    float outputLevel = 0.0f;      // peak linear
+    float keyMin = 0.0f;           // mono sidechain, signed
+    float keyMax = 0.0f;
+    float mainMin = 0.0f;          // main input (pre look-ahead), signed
+    float mainMax = 0.0f;
+    float gainMin = 1.0f;          // applied gain, linear
+    float gainMax = 1.0f;
+    int numSamples = 0;
+    bool triggered = false;
+};
+
+// Wait-free single-producer/single-consumer ring of telemetry frames.
+// The audio thread pushes, the editor drains. Frames are dropped when full.
+// Only the consumer moves the read index: the producer discards stale
+// frames by bumping a generation that the consumer filters on.
+//
+// Sized for a few hundred ms of frames (about 680 ms of 64-sample
+// sub-blocks at 48 kHz): the editor drains at 60 Hz, and this state is
+// per instance, so large sessions pay for every extra frame.
+class TelemetryFifo
+{
+public:
+    static constexpr int capacity = 512;
+
+    bool push(const TelemetryFrame& frame) noexcept
+    {
+        const auto scope = fifo.write(1);
+        const auto index = scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2;
+        if (scope.blockSize1 + scope.blockSize2 == 0)
+            return false;
+
+        frames[(size_t)index] = frame;
+        frameGenerations[(size_t)index] = generation.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    // Producer: frames pushed so far will be skipped by the next drain
+    // (after prepare/reset, when they describe audio that no longer applies)
+    void discardPending() noexcept
+    {
+        generation.fetch_add(1, std::memory_order_release);
+    }
+
+    // Calls fn(const TelemetryFrame&) for every pending, current frame,
+    // oldest first. Returns the number of frames passed to fn.
+    template <typename Fn>
+    int drain(Fn&& fn)
+    {
+        const auto current = generation.load(std::memory_order_acquire);
+        const auto scope = fifo.read(fifo.getNumReady());
+        int count = 0;
+
+        auto visit = [&](int start, int size)
+        {
+            for (int i = start; i < start + size; ++i)
+            {
+                if (frameGenerations[(size_t)i] == current)
+                {
+                    fn(frames[(size_t)i]);
+                    ++count;
+                }
+            }
+        };
+
+        visit(scope.startIndex1, scope.blockSize1);
+        visit(scope.startIndex2, scope.blockSize2);
+        return count;
+    }
+
+private:
+    juce::AbstractFifo fifo { capacity };
+    std::array<TelemetryFrame, capacity> frames {};
+    std::array<juce::uint32, capacity> frameGenerations {};
+    std::atomic<juce::uint32> generation { 0 };
+};
@@ -0,0 +1,168 @@
+#include "LiveStats.h"
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+ #include <fcntl.h>
+ #include <sys/mman.h>
+ #include <unistd.h>
+ #define DUCKER_LIVE_STATS_SHM 1
+#else
+ #define DUCKER_LIVE_STATS_SHM 0
+#endif
+
+namespace LiveStats
+{
+    bool read(const Slot& slot, Snapshot& snapshot) noexcept
+    {
+        for (int attempt = 0; attempt < 1000; ++attempt)
+        {
+            auto before = slot.sequence.load(std::memory_order_acquire);
+            if ((before & 1) != 0)
+                continue;
+
+            for (size_t i = 0; i < numFields; ++i)
+                snapshot[i] = slot.fields[i].load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before)
+                return true;
+        }
+
+        return false;
+    }
+
+    juce::String getSegmentName(juce::int64 processId)
+    {
+        return "/ducker-stats." + juce::String(processId);
+    }
+
+    //==============================================================================
+    SegmentView::SegmentView(juce::int64 processId)
+    {
+       #if DUCKER_LIVE_STATS_SHM
+        auto fd = shm_open(getSegmentName(processId).toRawUTF8(), O_RDONLY, 0);
+        if (fd < 0)
+            return;
+
+        auto* mapped = mmap(nullptr, sizeof(Segment), PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (mapped == MAP_FAILED)
+            return;
+
+        segment = static_cast<const Segment*>(mapped);
+        if (segment->magic.load(std::memory_order_acquire) != segmentMagic || segment->version != layoutVersion)
+        {
+            munmap(mapped, sizeof(Segment));
+            segment = nullptr;
+        }
+       #else
+        juce::ignoreUnused(processId);
+       #endif
+    }
+
+    SegmentView::~SegmentView()
+    {
+       #if DUCKER_LIVE_STATS_SHM
+        if (segment != nullptr)
+            munmap(const_cast<Segment*>(segment), sizeof(Segment));
+       #endif
+    }
+
+    //==============================================================================
+    bool SharedSegment::isRequested()
+    {
+        auto value = juce::SystemStats::getEnvironmentVariable("DUCKER_STATS", {});
+        return DUCKER_LIVE_STATS_SHM && value.isNotEmpty() && value != "0";
+    }
+
+    SharedSegment::SharedSegment()
+    {
+       #if DUCKER_LIVE_STATS_SHM
+        if (!isRequested())
+            return;
+
+        auto processId = (juce::int64)getpid();
+        name = getSegmentName(processId);
+
+        // A segment left by a crashed process with a recycled pid is replaced
+        shm_unlink(name.toRawUTF8());
+        auto fd = shm_open(name.toRawUTF8(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0)
+            return;
+
+        void* mapped = MAP_FAILED;
+        if (ftruncate(fd, (off_t)sizeof(Segment)) == 0)
+            mapped = mmap(nullptr, sizeof(Segment), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (mapped == MAP_FAILED)
+        {
+            shm_unlink(name.toRawUTF8());
+            return;
+        }
+
+        // ftruncate zero-fills, which is the initial state of every slot
+        segment = static_cast<Segment*>(mapped);
+        segment->version = layoutVersion;
+        segment->processId = processId;
+        segment->startTimeMs = juce::Time::currentTimeMillis();
+        segment->magic.store(segmentMagic, std::memory_order_release);
+       #endif
+    }
+
+    SharedSegment::~SharedSegment()
+    {
+       #if DUCKER_LIVE_STATS_SHM
+        if (segment == nullptr)
+            return;
+
+        munmap(segment, sizeof(Segment));
+        shm_unlink(name.toRawUTF8());
+       #endif
+    }
+
+    Slot* SharedSegment::claim()
+    {
+        if (segment == nullptr)
+            return nullptr;
+
+        for (auto& slot : segment->slots)
+        {
+            juce::uint32 expected = 0;
+            if (slot.active.compare_exchange_strong(expected, 1))
+            {
+                slot.sequence.fetch_add(1);
+                for (auto& field : slot.fields)
+                    field.store(0, std::memory_order_relaxed);
+                slot.sequence.fetch_add(1);
+                return &slot;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void SharedSegment::release(Slot& slot)
+    {
+        slot.active.store(0);
+    }
+
+    //==============================================================================
+    Publisher::Publisher()
+    {
+        if (!SharedSegment::isRequested())
+            return;
+
+        shared = std::make_unique<juce::SharedResourcePointer<SharedSegment>>();
+        slot = (*shared)->claim();
+
+        if (slot == nullptr)
+            shared.reset();
+    }
+
+    Publisher::~Publisher()
+    {
+        if (slot != nullptr)
+            (*shared)->release(*slot);
+    }
+}
@@ -0,0 +1,157 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+// Live counters in POSIX shared memory, for headless render nodes.
+//
+// Set DUCKER_STATS=1 before the process starts. The first instance then
+// creates /ducker-stats.<pid> (a Segment), and every instance claims a Slot in
+// it. Each block the audio thread adds to its running totals and publishes
+// them under the slot's seqlock: a handful of relaxed atomic stores, with no
+// syscalls or locks. Readers (ducker_stats) map the segment read-only and retry
+// until they see an even, unchanged sequence number. The segment is unlinked
+// when the last instance goes away.
+//
+// Unset, or on platforms without POSIX shared memory, nothing is created and
+// the per-block calls are one branch.
+namespace LiveStats
+{
+    constexpr juce::uint32 segmentMagic = 0x44535453;    // "DSTS"
+    constexpr juce::uint32 layoutVersion = 1;
+    constexpr int maxInstances = 512;
+
+    enum Field
+    {
+        blocks,
+        samples,
+        busyNs,            // wall time inside processBlock
+        peakBlockNs,
+        deadlineMisses,    // blocks that took longer than their audio
+        triggers,
+        duckedSamples,
+        sampleRate,        // Hz, rounded
+        numFields
+    };
+
+    using Snapshot = std::array<juce::uint64, numFields>;
+
+    struct alignas(64) Slot
+    {
+        std::atomic<juce::uint32> active { 0 };
+        std::atomic<juce::uint32> sequence { 0 };    // odd while a write is in progress
+        std::array<std::atomic<juce::uint64>, numFields> fields {};
+    };
+
+    struct Segment
+    {
+        std::atomic<juce::uint32> magic { 0 };       // written last, once the header is valid
+        juce::uint32 version = 0;
+        juce::int64 processId = 0;
+        juce::int64 startTimeMs = 0;
+        std::array<Slot, maxInstances> slots;
+    };
+
+    static_assert(std::atomic<juce::uint64>::is_always_lock_free,
+                  "Seqlock fields must be address-free to live in shared memory");
+
+    // Consistent copy of a slot; false if a writer kept it busy
+    bool read(const Slot& slot, Snapshot& snapshot) noexcept;
+
+    juce::String getSegmentName(juce::int64 processId);
+
+    // Read-only mapping of another process's segment (reader side)
+    class SegmentView
+    {
+    public:
+        explicit SegmentView(juce::int64 processId);
+        ~SegmentView();
+
+        const Segment* get() const noexcept { return segment; }
+
+    private:
+        const Segment* segment = nullptr;
+        JUCE_DECLARE_NON_COPYABLE(SegmentView)
+    };
+
+    class SharedSegment;
+
+    // Per-instance writer, driven from processBlock
+    class Publisher
+    {
+    public:
+        Publisher();
+        ~Publisher();
+
+        bool isActive() const noexcept { return slot != nullptr; }
+
+        void beginBlock() noexcept
+        {
+            if (isActive())
+                blockStart = std::chrono::steady_clock::now();
+        }
+
+        void endBlock(int numSamples, double rate, juce::uint64 triggerCount, juce::uint64 duckedCount) noexcept
+        {
+            if (!isActive())
+                return;
+
+            auto elapsed = (juce::uint64)std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now() - blockStart).count();
+
+            totals[blocks] += 1;
+            totals[samples] += (juce::uint64)numSamples;
+            totals[busyNs] += elapsed;
+            totals[peakBlockNs] = juce::jmax(totals[peakBlockNs], elapsed);
+            if (rate > 0.0 && (double)elapsed > 1.0e9 * numSamples / rate)
+                totals[deadlineMisses] += 1;
+            totals[triggers] = triggerCount;
+            totals[duckedSamples] = duckedCount;
+            totals[sampleRate] = (juce::uint64)(rate + 0.5);
+
+            publish();
+        }
+
+    private:
+        void publish() noexcept
+        {
+            auto sequence = slot->sequence.load(std::memory_order_relaxed);
+            slot->sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            for (size_t i = 0; i < numFields; ++i)
+                slot->fields[i].store(totals[i], std::memory_order_relaxed);
+
+            slot->sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+        std::unique_ptr<juce::SharedResourcePointer<SharedSegment>> shared;
+        Slot* slot = nullptr;
+        Snapshot totals {};
+        std::chrono::steady_clock::time_point blockStart;
+
+        JUCE_DECLARE_NON_COPYABLE(Publisher)
+    };
+
+    // Process-wide owner of this process's segment
+    class SharedSegment
+    {
+    public:
+        SharedSegment();
+        ~SharedSegment();
+
+        // Message thread; nullptr if disabled or every slot is taken
+        Slot* claim();
+        void release(Slot& slot);
+
+        static bool isRequested();
+
+    private:
+        Segment* segment = nullptr;
+        juce::String name;
+        JUCE_DECLARE_NON_COPYABLE(SharedSegment)
+    };
+}
@@ -0,0 +1,358 @@
+#include "RealtimeSafety.h"
+
+#if DUCKER_RT_SAFETY
+
+#include <cstdio>
+#include <new>
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+ #include <execinfo.h>
+ #include <pthread.h>
+ #define DUCKER_RT_SAFETY_HAS_BACKTRACE 1
+#else
+ #define DUCKER_RT_SAFETY_HAS_BACKTRACE 0
+#endif
+
+#ifndef DUCKER_RT_SAFETY_WRAP_LIBC
+ #define DUCKER_RT_SAFETY_WRAP_LIBC 0
+#endif
+
+#if DUCKER_RT_SAFETY_WRAP_LIBC
+// Originals, when linked with -Wl,--wrap=malloc,...
+extern "C"
+{
+    void* __real_malloc(size_t);
+    void* __real_calloc(size_t, size_t);
+    void* __real_realloc(void*, size_t);
+    void __real_free(void*);
+    int __real_pthread_mutex_lock(pthread_mutex_t*);
+}
+#endif
+
+namespace RealtimeSafety
+{
+namespace
+{
+    struct Record
+    {
+        std::atomic<bool> ready { false };
+        ViolationType type = ViolationType::allocation;
+        size_t bytes = 0;
+        juce::Thread::ThreadID thread = nullptr;
+        int numFrames = 0;
+        void* frames[maxStackFrames] = {};
+    };
+
+    // Static storage: nothing here allocates once the plugin is loaded
+    Record records[maxRecorded];
+    std::atomic<int> numClaimed { 0 };
+
+    std::atomic<juce::uint64> violationCounts[3] {};
+    std::atomic<juce::uint64> numBlocks { 0 };
+    std::atomic<juce::uint64> numDeadlineMisses { 0 };
+    std::atomic<double> worstLoad { 0.0 };
+
+    // > 0 while inside processBlock / while checks are suspended on this thread
+    thread_local int audioDepth = 0;
+    thread_local int suspendDepth = 0;
+
+    bool isChecking() noexcept
+    {
+        return audioDepth > 0 && suspendDepth == 0;
+    }
+
+    void record(ViolationType type, size_t bytes) noexcept
+    {
+        violationCounts[(int)type].fetch_add(1, std::memory_order_relaxed);
+
+        auto index = numClaimed.fetch_add(1, std::memory_order_relaxed);
+        if (index >= maxRecorded)
+            return;
+
+        // Capturing the stack must not trip the checks itself
+        ++suspendDepth;
+
+        auto& r = records[index];
+        r.type = type;
+        r.bytes = bytes;
+        r.thread = juce::Thread::getCurrentThreadId();
+       #if DUCKER_RT_SAFETY_HAS_BACKTRACE
+        r.numFrames = backtrace(r.frames, maxStackFrames);
+       #endif
+        r.ready.store(true, std::memory_order_release);
+
+        --suspendDepth;
+    }
+
+   #if DUCKER_RT_SAFETY_HAS_BACKTRACE
+    // The first backtrace() loads the unwinder; do that at load time rather
+    // than inside the first violating audio callback
+    const bool backtraceWarmedUp = []
+    {
+        void* frame[1];
+        return backtrace(frame, 1) >= 0;
+    }();
+   #endif
+
+    // Underlying allocator for the operator new/delete replacements (not
+    // the wrapped malloc, so each allocation is recorded once)
+    void* rawAllocate(size_t size) noexcept
+    {
+       #if DUCKER_RT_SAFETY_WRAP_LIBC
+        return __real_malloc(size);
+       #else
+        return std::malloc(size);
+       #endif
+    }
+
+    void rawFree(void* ptr) noexcept
+    {
+       #if DUCKER_RT_SAFETY_WRAP_LIBC
+        __real_free(ptr);
+       #else
+        std::free(ptr);
+       #endif
+    }
+
+    void* rawAllocateAligned(size_t size, size_t alignment) noexcept
+    {
+       #if JUCE_WINDOWS
+        return _aligned_malloc(size, alignment);
+       #else
+        void* ptr = nullptr;
+        return posix_memalign(&ptr, juce::jmax(alignment, sizeof(void*)), size) == 0 ? ptr : nullptr;
+       #endif
+    }
+
+    void rawFreeAligned(void* ptr) noexcept
+    {
+       #if JUCE_WINDOWS
+        _aligned_free(ptr);
+       #else
+        rawFree(ptr);
+       #endif
+    }
+
+    void* checkedAllocate(size_t size, size_t alignment) noexcept
+    {
+        if (isChecking())
+            record(ViolationType::allocation, size);
+
+        size = juce::jmax(size, (size_t)1);
+        return alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__ ? rawAllocateAligned(size, alignment)
+                                                            : rawAllocate(size);
+    }
+
+    void checkedFree(void* ptr, size_t alignment) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+
+        if (isChecking())
+            record(ViolationType::deallocation, 0);
+
+        if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            rawFreeAligned(ptr);
+        else
+            rawFree(ptr);
+    }
+
+    void* allocateOrThrow(size_t size, size_t alignment)
+    {
+        if (auto* ptr = checkedAllocate(size, alignment))
+            return ptr;
+        throw std::bad_alloc();
+    }
+
+    const char* getTypeName(ViolationType type)
+    {
+        switch (type)
+        {
+            case ViolationType::allocation:   return "allocation";
+            case ViolationType::deallocation: return "deallocation";
+            case ViolationType::lock:         return "mutex lock";
+        }
+        return "";
+    }
+
+    // Prints the report to stderr at process exit if anything ran checked
+    struct ExitReport
+    {
+        ~ExitReport()
+        {
+            if (numBlocks.load() > 0)
+                std::fputs(getReport().toRawUTF8(), stderr);
+        }
+    } exitReport;
+}
+
+//==============================================================================
+ScopedAudioThread::ScopedAudioThread(int numSamples, double sampleRate)
+{
+    outermost = audioDepth++ == 0;
+
+    if (outermost)
+    {
+        budgetSeconds = sampleRate > 0.0 ? numSamples / sampleRate : 0.0;
+        startTicks = juce::Time::getHighResolutionTicks();
+    }
+}
+
+ScopedAudioThread::~ScopedAudioThread()
+{
+    if (outermost)
+    {
+        auto elapsed = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        numBlocks.fetch_add(1, std::memory_order_relaxed);
+
+        if (budgetSeconds > 0.0)
+        {
+            auto load = elapsed / budgetSeconds;
+            if (load > 1.0)
+                numDeadlineMisses.fetch_add(1, std::memory_order_relaxed);
+
+            auto worst = worstLoad.load(std::memory_order_relaxed);
+            while (load > worst && !worstLoad.compare_exchange_weak(worst, load, std::memory_order_relaxed)) {}
+        }
+    }
+
+    --audioDepth;
+}
+
+ScopedAllowBlocking::ScopedAllowBlocking()  { ++suspendDepth; }
+ScopedAllowBlocking::~ScopedAllowBlocking() { --suspendDepth; }
+
+Stats getStats()
+{
+    Stats s;
+    s.allocations = violationCounts[(int)ViolationType::allocation].load();
+    s.deallocations = violationCounts[(int)ViolationType::deallocation].load();
+    s.locks = violationCounts[(int)ViolationType::lock].load();
+    s.blocks = numBlocks.load();
+    s.deadlineMisses = numDeadlineMisses.load();
+    s.worstLoad = worstLoad.load();
+    return s;
+}
+
+juce::String getReport(int maxViolations)
+{
+    auto s = getStats();
+
+    juce::String report;
+    report << "Real-time safety: " << (juce::int64)s.blocks << " blocks, "
+           << (juce::int64)s.deadlineMisses << " over budget (worst " << juce::String(s.worstLoad * 100.0, 1) << "%), "
+           << (juce::int64)s.allocations << " allocations, " << (juce::int64)s.deallocations << " deallocations, "
+           << (juce::int64)s.locks << " locks on the audio thread\n";
+
+    auto numRecorded = juce::jmin(numClaimed.load(), maxRecorded, maxViolations);
+
+    for (int i = 0; i < numRecorded; ++i)
+    {
+        auto& r = records[i];
+        if (!r.ready.load(std::memory_order_acquire))
+            continue;
+
+        report << "\n#" << (i + 1) << " " << getTypeName(r.type);
+        if (r.bytes > 0)
+            report << " of " << (juce::int64)r.bytes << " bytes";
+        report << " on thread 0x" << juce::String::toHexString((juce::pointer_sized_int)r.thread) << "\n";
+
+       #if DUCKER_RT_SAFETY_HAS_BACKTRACE
+        if (auto** symbols = backtrace_symbols(r.frames, r.numFrames))
+        {
+            for (int f = 0; f < r.numFrames; ++f)
+                report << "    " << symbols[f] << "\n";
+            std::free(symbols);
+        }
+       #endif
+    }
+
+    return report;
+}
+
+void reset()
+{
+    for (auto& r : records)
+        r.ready.store(false);
+
+    numClaimed = 0;
+    for (auto& count : violationCounts)
+        count = 0;
+    numBlocks = 0;
+    numDeadlineMisses = 0;
+    worstLoad = 0.0;
+}
+}
+
+//==============================================================================
+// Interception
+
+#if DUCKER_RT_SAFETY_WRAP_LIBC
+extern "C"
+{
+    void* __wrap_malloc(size_t size)
+    {
+        if (RealtimeSafety::isChecking())
+            RealtimeSafety::record(RealtimeSafety::ViolationType::allocation, size);
+        return __real_malloc(size);
+    }
+
+    void* __wrap_calloc(size_t count, size_t size)
+    {
+        if (RealtimeSafety::isChecking())
+            RealtimeSafety::record(RealtimeSafety::ViolationType::allocation, count * size);
+        return __real_calloc(count, size);
+    }
+
+    void* __wrap_realloc(void* ptr, size_t size)
+    {
+        if (RealtimeSafety::isChecking())
+            RealtimeSafety::record(RealtimeSafety::ViolationType::allocation, size);
+        return __real_realloc(ptr, size);
+    }
+
+    void __wrap_free(void* ptr)
+    {
+        if (ptr != nullptr && RealtimeSafety::isChecking())
+            RealtimeSafety::record(RealtimeSafety::ViolationType::deallocation, 0);
+        __real_free(ptr);
+    }
+
+    int __wrap_pthread_mutex_lock(pthread_mutex_t* mutex)
+    {
+        if (RealtimeSafety::isChecking())
+            RealtimeSafety::record(RealtimeSafety::ViolationType::lock, 0);
+        return __real_pthread_mutex_lock(mutex);
+    }
+}
+#endif
+
+// Replaced for the whole binary. Default-aligned requests go through the
+// unwrapped allocator, so each one is recorded exactly once.
+using RealtimeSafety::allocateOrThrow;
+using RealtimeSafety::checkedAllocate;
+using RealtimeSafety::checkedFree;
+
+void* operator new(size_t size)                                              { return allocateOrThrow(size, 0); }
+void* operator new[](size_t size)                                            { return allocateOrThrow(size, 0); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept              { return checkedAllocate(size, 0); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept            { return checkedAllocate(size, 0); }
+void* operator new(size_t size, std::align_val_t a)                          { return allocateOrThrow(size, (size_t)a); }
+void* operator new[](size_t size, std::align_val_t a)                        { return allocateOrThrow(size, (size_t)a); }
+void* operator new(size_t size, std::align_val_t a, const std::nothrow_t&) noexcept   { return checkedAllocate(size, (size_t)a); }
+void* operator new[](size_t size, std::align_val_t a, const std::nothrow_t&) noexcept { return checkedAllocate(size, (size_t)a); }
+
+void operator delete(void* ptr) noexcept                                     { checkedFree(ptr, 0); }
+void operator delete[](void* ptr) noexcept                                   { checkedFree(ptr, 0); }
+void operator delete(void* ptr, size_t) noexcept                             { checkedFree(ptr, 0); }
+void operator delete[](void* ptr, size_t) noexcept                           { checkedFree(ptr, 0); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept              { checkedFree(ptr, 0); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept            { checkedFree(ptr, 0); }
+void operator delete(void* ptr, std::align_val_t a) noexcept                 { checkedFree(ptr, (size_t)a); }
+void operator delete[](void* ptr, std::align_val_t a) noexcept               { checkedFree(ptr, (size_t)a); }
+void operator delete(void* ptr, size_t, std::align_val_t a) noexcept         { checkedFree(ptr, (size_t)a); }
+void operator delete[](void* ptr, size_t, std::align_val_t a) noexcept       { checkedFree(ptr, (size_t)a); }
+void operator delete(void* ptr, std::align_val_t a, const std::nothrow_t&) noexcept   { checkedFree(ptr, (size_t)a); }
+void operator delete[](void* ptr, std::align_val_t a, const std::nothrow_t&) noexcept { checkedFree(ptr, (size_t)a); }
+
+#endif
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Real-time safety checks for the audio thread (debug/profiling builds).
+//
+// Build with DUCKER_RT_SAFETY=1 (CMake: -DDUCKER_RT_SAFETY=ON). processBlock
+// then runs inside a ScopedAudioThread, and while it is active on a thread:
+//   - operator new/delete (all platforms), and malloc/calloc/realloc/free and
+//     pthread_mutex_lock (Linux, linked with --wrap) are recorded as
+//     violations, with the call stack of the offending call;
+//   - the block's wall time is compared with its budget (numSamples /
+//     sampleRate) and overruns are counted as deadline misses.
+// Violations go into a fixed, preallocated table shared by all instances:
+// the first maxRecorded keep their stacks, later ones are only counted.
+// Stacks are symbolised when a report is requested, off the audio thread.
+//
+// With DUCKER_RT_SAFETY=0 (the default) everything here compiles to nothing.
+#ifndef DUCKER_RT_SAFETY
+ #define DUCKER_RT_SAFETY 0
+#endif
+
+namespace RealtimeSafety
+{
+    enum class ViolationType
+    {
+        allocation,
+        deallocation,
+        lock
+    };
+
+    struct Stats
+    {
+        juce::uint64 allocations = 0;
+        juce::uint64 deallocations = 0;
+        juce::uint64 locks = 0;
+        juce::uint64 blocks = 0;
+        juce::uint64 deadlineMisses = 0;
+        double worstLoad = 0.0;        // longest block, as a fraction of its budget
+    };
+
+   #if DUCKER_RT_SAFETY
+    constexpr bool isEnabled = true;
+    constexpr int maxRecorded = 256;
+    constexpr int maxStackFrames = 24;
+
+    // Marks the calling thread as real-time for the guard's lifetime and
+    // times the block against its budget. Nests (only the outermost times).
+    class ScopedAudioThread
+    {
+    public:
+        ScopedAudioThread(int numSamples, double sampleRate);
+        ~ScopedAudioThread();
+
+    private:
+        juce::int64 startTicks = 0;
+        double budgetSeconds = 0.0;
+        bool outermost = false;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedAudioThread)
+    };
+
+    // Suspends checking on this thread, for calls that are known to be safe
+    // in context but trip the checks (e.g. a first-use lazy initialisation)
+    class ScopedAllowBlocking
+    {
+    public:
+        ScopedAllowBlocking();
+        ~ScopedAllowBlocking();
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE(ScopedAllowBlocking)
+    };
+
+    Stats getStats();
+
+    // Counts plus the recorded violations with symbolised stacks (allocates;
+    // call from the message thread or at shutdown, never from the audio thread)
+    juce::String getReport(int maxViolations = 16);
+
+    void reset();
+   #else
+    constexpr bool isEnabled = false;
+
+    struct ScopedAudioThread { ScopedAudioThread(int, double) {} };
+    struct ScopedAllowBlocking { ScopedAllowBlocking() {} };
+
+    inline Stats getStats() { return {}; }
+    inline juce::String getReport(int = 16) { return {}; }
+    inline void reset() {}
+   #endif
+}
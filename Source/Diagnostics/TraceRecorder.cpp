@@ -0,0 +1,243 @@
+#include "TraceRecorder.h"
+
+#include <chrono>
+#include <cstdio>
+
+#if JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#elif JUCE_MAC || JUCE_IOS
+ #include <pthread.h>
+ #include <unistd.h>
+#elif JUCE_WINDOWS
+ #include <process.h>
+#endif
+
+namespace Tracing
+{
+    static const char* getStageName(Stage stage)
+    {
+        const char* names[numStages] = { "processBlock", "Sidechain copy", "Parameters", "Ducker::process" };
+        return names[juce::jlimit(0, numStages - 1, (int)stage)];
+    }
+
+    static juce::int64 getProcessId()
+    {
+       #if JUCE_WINDOWS
+        return (juce::int64)_getpid();
+       #else
+        return (juce::int64)getpid();
+       #endif
+    }
+
+    //==============================================================================
+    juce::uint64 TraceBuffer::now() noexcept
+    {
+        using namespace std::chrono;
+        return (juce::uint64)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // OS thread ID, cached per thread so the syscall happens once
+    juce::uint64 TraceBuffer::getCurrentThreadId() noexcept
+    {
+        thread_local const juce::uint64 id = []
+        {
+           #if JUCE_LINUX || JUCE_BSD || JUCE_ANDROID
+            return (juce::uint64)syscall(SYS_gettid);
+           #elif JUCE_MAC || JUCE_IOS
+            juce::uint64 tid = 0;
+            pthread_threadid_np(nullptr, &tid);
+            return tid;
+           #else
+            return (juce::uint64)(juce::pointer_sized_int)juce::Thread::getCurrentThreadId();
+           #endif
+        }();
+
+        return id;
+    }
+
+    TraceBuffer::TraceBuffer()
+    {
+        static std::atomic<int> nextInstanceId { 1 };
+
+        if (TraceWriter::getTraceFile() == juce::File())
+            return;
+
+        auto shared = std::make_unique<juce::SharedResourcePointer<TraceWriter>>();
+        if (!(*shared)->isOpen())
+            return;
+
+        instanceId = nextInstanceId++;
+        events.resize((size_t)capacity);
+        writer = std::move(shared);
+        (*writer)->add(*this);
+    }
+
+    TraceBuffer::~TraceBuffer()
+    {
+        if (writer != nullptr)
+            (*writer)->remove(*this);
+    }
+
+    //==============================================================================
+    TraceWriter::TraceWriter() : juce::Thread("Ducker trace writer"), processId(getProcessId())
+    {
+        auto file = getTraceFile();
+        if (file == juce::File())
+            return;
+
+        // The writer lives as long as some instance does. The first one in the
+        // process replaces any file left by an earlier run; if all instances
+        // close and a new one opens, its trace goes to a numbered sibling so
+        // the finished one is kept.
+        static std::atomic<int> writersCreated { 0 };
+        if (writersCreated++ == 0)
+            file.deleteFile();
+        else
+            file = file.getNonexistentSibling(true);   // "<name> (2).json"
+
+        stream = std::make_unique<juce::FileOutputStream>(file);
+        if (stream->failedToOpen())
+        {
+            stream.reset();
+            return;
+        }
+
+        // JSON array format: every event after the first is written as ",\n{...}"
+        // so the file stays loadable up to the last flush
+        *stream << "[\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << juce::String(processId)
+                << ",\"args\":{\"name\":\"Ducker (" << juce::String(processId) << ")\"}}";
+        stream->flush();
+
+        startThread();
+    }
+
+    TraceWriter::~TraceWriter()
+    {
+        if (stream == nullptr)
+            return;
+
+        stopThread(2000);
+        flush();
+        *stream << "\n]\n";
+        stream->flush();
+    }
+
+    juce::File TraceWriter::getTraceFile()
+    {
+        // Resolved once, so a directory gives one timestamped name per process
+        static const juce::File file = []
+        {
+            auto path = juce::SystemStats::getEnvironmentVariable("DUCKER_TRACE", {});
+            if (path.isEmpty() || !juce::File::isAbsolutePath(path))
+                return juce::File();
+
+            juce::File f(path);
+            if (f.isDirectory())
+                return f.getChildFile("ducker-" + juce::String(getProcessId()) + "-"
+                                      + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".json");
+            return f;
+        }();
+
+        return file;
+    }
+
+    void TraceWriter::add(TraceBuffer& buffer)
+    {
+        const juce::ScopedLock sl(lock);
+        buffers.add(&buffer);
+    }
+
+    void TraceWriter::remove(TraceBuffer& buffer)
+    {
+        const juce::ScopedLock sl(lock);
+        buffer.drain([&](const Event& event) { write(buffer, event); });
+        buffers.removeFirstMatchingValue(&buffer);
+    }
+
+    void TraceWriter::run()
+    {
+        while (!threadShouldExit())
+        {
+            wait(50);
+            flush();
+        }
+    }
+
+    void TraceWriter::flush()
+    {
+        const juce::ScopedLock sl(lock);
+
+        for (auto* buffer : buffers)
+        {
+            buffer->drain([&](const Event& event) { write(*buffer, event); });
+
+            // Report ring overflows as they happen rather than hiding the gap
+            auto dropped = buffer->getNumDropped();
+            auto& reported = droppedReported[buffer->getInstanceId()];
+            if (dropped != reported)
+            {
+                char line[256];
+                auto n = std::snprintf(line, sizeof(line),
+                                       ",\n{\"name\":\"events dropped\",\"ph\":\"i\",\"s\":\"p\",\"ts\":%.3f,\"pid\":%lld,"
+                                       "\"args\":{\"instance\":%d,\"total\":%llu}}",
+                                       (double)TraceBuffer::now() * 0.001, (long long)processId,
+                                       buffer->getInstanceId(), (unsigned long long)dropped);
+                stream->write(line, (size_t)n);
+                reported = dropped;
+            }
+        }
+
+        stream->flush();
+    }
+
+    void TraceWriter::write(const TraceBuffer& buffer, const Event& event)
+    {
+        char line[384];
+        int n = 0;
+
+        if (namedThreads.insert(event.threadId).second)
+        {
+            n = std::snprintf(line, sizeof(line),
+                              ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%lld,\"tid\":%llu,"
+                              "\"args\":{\"name\":\"Audio thread %llu\"}}",
+                              (long long)processId, (unsigned long long)event.threadId,
+                              (unsigned long long)event.threadId);
+            stream->write(line, (size_t)n);
+        }
+
+        auto startUs = (double)event.startNs * 0.001;
+        auto durationUs = (double)event.durationNs * 0.001;
+
+        if (event.stage != processBlock)
+        {
+            n = std::snprintf(line, sizeof(line),
+                              ",\n{\"name\":\"%s\",\"cat\":\"ducker\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                              "\"pid\":%lld,\"tid\":%llu,\"args\":{\"instance\":%d}}",
+                              getStageName(event.stage), startUs, durationUs, (long long)processId,
+                              (unsigned long long)event.threadId, buffer.getInstanceId());
+            stream->write(line, (size_t)n);
+            return;
+        }
+
+        auto load = event.budgetNs > 0 ? (double)event.durationNs / event.budgetNs : 0.0;
+
+        n = std::snprintf(line, sizeof(line),
+                          ",\n{\"name\":\"processBlock\",\"cat\":\"ducker\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,"
+                          "\"pid\":%lld,\"tid\":%llu,\"args\":{\"instance\":%d,\"samples\":%d,"
+                          "\"budget_us\":%.3f,\"load\":%.4f}}",
+                          startUs, durationUs, (long long)processId, (unsigned long long)event.threadId,
+                          buffer.getInstanceId(), (int)event.numSamples, (double)event.budgetNs * 0.001, load);
+        stream->write(line, (size_t)n);
+
+        if (load > 1.0)
+        {
+            n = std::snprintf(line, sizeof(line),
+                              ",\n{\"name\":\"deadline miss\",\"cat\":\"ducker\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,"
+                              "\"pid\":%lld,\"tid\":%llu,\"args\":{\"instance\":%d,\"load\":%.4f}}",
+                              startUs + durationUs, (long long)processId, (unsigned long long)event.threadId,
+                              buffer.getInstanceId(), load);
+            stream->write(line, (size_t)n);
+        }
+    }
+}
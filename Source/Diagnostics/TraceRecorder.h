@@ -0,0 +1,161 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+// Opt-in Chrome trace (Perfetto-compatible JSON) of block processing.
+//
+// Set DUCKER_TRACE to a file path (or an existing directory, to get one
+// ducker-<pid>-<time>.json per process) before the host starts. Every
+// instance then records, per block, the begin/end of processBlock and of its
+// sidechain copy, parameter update and Ducker::process stages, with block
+// size, real-time budget and OS thread ID. Events go into a preallocated
+// per-instance ring (wait-free, single producer) and a shared background
+// thread drains all rings every 50 ms into the file. Blocks that overran their
+// budget also get an instant "deadline miss" marker.
+//
+// Timestamps are steady_clock (CLOCK_MONOTONIC on Linux) in microseconds and
+// thread IDs are the OS ones, so the trace lines up with perf, systrace and
+// host-side traces. The file is a JSON array that is valid to load even if
+// the process dies before closing it. If every instance is closed and a new
+// one created, tracing continues in "<name> (2).json" rather than
+// overwriting the finished trace.
+//
+// With DUCKER_TRACE unset nothing is allocated and each call is one branch.
+namespace Tracing
+{
+    enum Stage : juce::uint8
+    {
+        processBlock,
+        sidechainCopy,
+        parameters,
+        duckerProcess,
+        numStages
+    };
+
+    struct Event
+    {
+        juce::uint64 startNs = 0;
+        juce::uint64 threadId = 0;
+        juce::uint32 durationNs = 0;
+        juce::uint32 budgetNs = 0;     // processBlock only
+        juce::int32 numSamples = 0;
+        Stage stage = processBlock;
+    };
+
+    class TraceWriter;
+
+    // Per-instance recorder, driven from the audio thread like
+    // StageProfiling::Profiler: beginBlock(), a lap() per stage, endBlock().
+    class TraceBuffer
+    {
+    public:
+        static constexpr int capacity = 8192;
+
+        TraceBuffer();
+        ~TraceBuffer();
+
+        bool isActive() const noexcept { return writer != nullptr; }
+
+        void beginBlock() noexcept
+        {
+            if (!isActive())
+                return;
+
+            threadId = getCurrentThreadId();
+            blockStart = last = now();
+        }
+
+        // Records [previous lap, now) as a stage event
+        void lap(Stage stage) noexcept
+        {
+            if (!isActive())
+                return;
+
+            auto t = now();
+            push({ last, threadId, (juce::uint32)(t - last), 0, 0, stage });
+            last = t;
+        }
+
+        void endBlock(int numSamples, double sampleRate) noexcept
+        {
+            if (!isActive())
+                return;
+
+            auto budget = sampleRate > 0.0 ? (juce::uint32)(1.0e9 * numSamples / sampleRate) : 0u;
+            push({ blockStart, threadId, (juce::uint32)(now() - blockStart), budget, numSamples, processBlock });
+        }
+
+        int getInstanceId() const noexcept { return instanceId; }
+
+        // Writer thread: calls fn(const Event&) for each pending event
+        template <typename Fn>
+        void drain(Fn&& fn)
+        {
+            const auto scope = fifo.read(fifo.getNumReady());
+            for (int i = 0; i < scope.blockSize1; ++i)
+                fn(events[(size_t)(scope.startIndex1 + i)]);
+            for (int i = 0; i < scope.blockSize2; ++i)
+                fn(events[(size_t)(scope.startIndex2 + i)]);
+        }
+
+        juce::uint64 getNumDropped() const noexcept { return numDropped.load(std::memory_order_relaxed); }
+
+        static juce::uint64 now() noexcept;
+        static juce::uint64 getCurrentThreadId() noexcept;
+
+    private:
+        void push(const Event& event) noexcept
+        {
+            const auto scope = fifo.write(1);
+            if (scope.blockSize1 > 0)
+                events[(size_t)scope.startIndex1] = event;
+            else if (scope.blockSize2 > 0)
+                events[(size_t)scope.startIndex2] = event;
+            else
+                numDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::unique_ptr<juce::SharedResourcePointer<TraceWriter>> writer;
+        juce::AbstractFifo fifo { capacity };
+        std::vector<Event> events;
+        std::atomic<juce::uint64> numDropped { 0 };
+        int instanceId = 0;
+
+        juce::uint64 blockStart = 0, last = 0, threadId = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(TraceBuffer)
+    };
+
+    // Process-wide flusher shared by all active TraceBuffers
+    class TraceWriter : private juce::Thread
+    {
+    public:
+        TraceWriter();
+        ~TraceWriter() override;
+
+        bool isOpen() const { return stream != nullptr; }
+
+        void add(TraceBuffer& buffer);
+        void remove(TraceBuffer& buffer);
+
+        // Path from DUCKER_TRACE (read once per process), or empty if tracing is off
+        static juce::File getTraceFile();
+
+    private:
+        void run() override;
+        void flush();
+        void write(const TraceBuffer& buffer, const Event& event);
+
+        juce::CriticalSection lock;    // message thread vs writer thread only
+        juce::Array<TraceBuffer*> buffers;
+        std::map<int, juce::uint64> droppedReported;   // by instance
+        std::set<juce::uint64> namedThreads;
+        std::unique_ptr<juce::FileOutputStream> stream;
+        juce::int64 processId = 0;
+    };
+}
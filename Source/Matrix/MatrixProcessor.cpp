@@ -0,0 +1,329 @@
+#include "MatrixProcessor.h"
+
+namespace
+{
+    juce::String keyId(int key, const char* name) { return "key" + juce::String(key + 1) + name; }
+    juce::String stemId(int stem, const char* name) { return "stem" + juce::String(stem + 1) + name; }
+    juce::String depthId(int key, int stem) { return keyId(key, "Stem") + juce::String(stem + 1) + "Depth"; }
+}
+
+DuckingMatrixProcessor::DuckingMatrixProcessor()
+     : AudioProcessor(BusesProperties()
+                      .withInput("Stem 1", juce::AudioChannelSet::stereo(), true)
+                      .withInput("Key 1", juce::AudioChannelSet::stereo(), true)
+                      .withInput("Key 2", juce::AudioChannelSet::stereo(), false)
+                      .withInput("Key 3", juce::AudioChannelSet::stereo(), false)
+                      .withInput("Key 4", juce::AudioChannelSet::stereo(), false)
+                      .withInput("Stem 2", juce::AudioChannelSet::stereo(), false)
+                      .withInput("Stem 3", juce::AudioChannelSet::stereo(), false)
+                      .withInput("Stem 4", juce::AudioChannelSet::stereo(), false)
+                      .withOutput("Stem 1", juce::AudioChannelSet::stereo(), true)
+                      .withOutput("Stem 2", juce::AudioChannelSet::stereo(), false)
+                      .withOutput("Stem 3", juce::AudioChannelSet::stereo(), false)
+                      .withOutput("Stem 4", juce::AudioChannelSet::stereo(), false)),
+       apvts(*this, nullptr, "Parameters", createParameterLayout())
+{
+    // Cache parameter pointers
+    for (int k = 0; k < numKeys; ++k)
+    {
+        auto& p = keyParameters[(size_t)k];
+        p.threshold = apvts.getRawParameterValue(keyId(k, "Threshold"));
+        p.attack = apvts.getRawParameterValue(keyId(k, "Attack"));
+        p.hold = apvts.getRawParameterValue(keyId(k, "Hold"));
+        p.release = apvts.getRawParameterValue(keyId(k, "Release"));
+        p.curveShape = apvts.getRawParameterValue(keyId(k, "CurveShape"));
+        p.hpfEnabled = apvts.getRawParameterValue(keyId(k, "HPFEnabled"));
+        p.hpfFreq = apvts.getRawParameterValue(keyId(k, "HPFFreq"));
+
+        for (int s = 0; s < numStems; ++s)
+            depth[(size_t)k][(size_t)s] = apvts.getRawParameterValue(depthId(k, s));
+    }
+
+    for (int s = 0; s < numStems; ++s)
+    {
+        stemParameters[(size_t)s].range = apvts.getRawParameterValue(stemId(s, "Range"));
+        stemParameters[(size_t)s].mix = apvts.getRawParameterValue(stemId(s, "Mix"));
+    }
+
+    lookAhead = apvts.getRawParameterValue("lookAhead");
+    bypass = apvts.getRawParameterValue("bypass");
+
+    for (int s = 0; s < numStems; ++s)
+        stemPointers[(size_t)s] = &stemViews[(size_t)s];
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout DuckingMatrixProcessor::createParameterLayout()
+{
+    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
+
+    // Per-key detection, with the same ranges as the single Ducker
+    for (int k = 0; k < numKeys; ++k)
+    {
+        auto prefix = "Key " + juce::String(k + 1) + " ";
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(keyId(k, "Threshold"), 1), prefix + "Threshold",
+            juce::NormalisableRange<float>(-60.0f, 0.0f, 0.1f, 1.0f),
+            -20.0f,
+            juce::AudioParameterFloatAttributes().withLabel("dB")));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(keyId(k, "Attack"), 1), prefix + "Attack",
+            juce::NormalisableRange<float>(0.1f, 100.0f, 0.1f, 0.4f),
+            10.0f,
+            juce::AudioParameterFloatAttributes().withLabel("ms")));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(keyId(k, "Hold"), 1), prefix + "Hold",
+            juce::NormalisableRange<float>(0.0f, 500.0f, 1.0f, 0.5f),
+            50.0f,
+            juce::AudioParameterFloatAttributes().withLabel("ms")));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(keyId(k, "Release"), 1), prefix + "Release",
+            juce::NormalisableRange<float>(10.0f, 2000.0f, 1.0f, 0.4f),
+            200.0f,
+            juce::AudioParameterFloatAttributes().withLabel("ms")));
+
+        params.push_back(std::make_unique<juce::AudioParameterChoice>(
+            juce::ParameterID(keyId(k, "CurveShape"), 1), prefix + "Curve Shape",
+            juce::StringArray{ "Linear", "Exponential", "Logarithmic", "S-Curve" }, 0));
+
+        params.push_back(std::make_unique<juce::AudioParameterBool>(
+            juce::ParameterID(keyId(k, "HPFEnabled"), 1), prefix + "HPF On", false));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(keyId(k, "HPFFreq"), 1), prefix + "HPF Freq",
+            juce::NormalisableRange<float>(20.0f, 2000.0f, 1.0f, 0.4f),
+            80.0f,
+            juce::AudioParameterFloatAttributes().withLabel("Hz")));
+    }
+
+    // Per-stem floor and mix
+    for (int s = 0; s < numStems; ++s)
+    {
+        auto prefix = "Stem " + juce::String(s + 1) + " ";
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(stemId(s, "Range"), 1), prefix + "Range/Floor",
+            juce::NormalisableRange<float>(-80.0f, 0.0f, 0.1f, 1.0f),
+            -40.0f,
+            juce::AudioParameterFloatAttributes().withLabel("dB")));
+
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(
+            juce::ParameterID(stemId(s, "Mix"), 1), prefix + "Mix",
+            juce::NormalisableRange<float>(0.0f, 100.0f, 1.0f, 1.0f),
+            100.0f,
+            juce::AudioParameterFloatAttributes().withLabel("%")));
+    }
+
+    // The matrix cells. Key 1 ducks stem 1 out of the box, so the default
+    // layout behaves like a single Ducker.
+    for (int k = 0; k < numKeys; ++k)
+        for (int s = 0; s < numStems; ++s)
+            params.push_back(std::make_unique<juce::AudioParameterFloat>(
+                juce::ParameterID(depthId(k, s), 1),
+                "Key " + juce::String(k + 1) + " > Stem " + juce::String(s + 1),
+                juce::NormalisableRange<float>(-40.0f, 0.0f, 0.1f, 1.0f),
+                (k == 0 && s == 0) ? -20.0f : 0.0f,
+                juce::AudioParameterFloatAttributes().withLabel("dB")));
+
+    params.push_back(std::make_unique<juce::AudioParameterFloat>(
+        juce::ParameterID("lookAhead", 1), "Look-Ahead",
+        juce::NormalisableRange<float>(0.0f, 20.0f, 0.1f, 0.5f),
+        5.0f,
+        juce::AudioParameterFloatAttributes().withLabel("ms")));
+
+    params.push_back(std::make_unique<juce::AudioParameterBool>(
+        juce::ParameterID("bypass", 1), "Bypass", false));
+
+    return { params.begin(), params.end() };
+}
+
+const juce::String DuckingMatrixProcessor::getName() const { return JucePlugin_Name; }
+bool DuckingMatrixProcessor::acceptsMidi() const { return false; }
+bool DuckingMatrixProcessor::producesMidi() const { return false; }
+bool DuckingMatrixProcessor::isMidiEffect() const { return false; }
+double DuckingMatrixProcessor::getTailLengthSeconds() const { return 0.0; }
+int DuckingMatrixProcessor::getNumPrograms() { return 1; }
+int DuckingMatrixProcessor::getCurrentProgram() { return 0; }
+void DuckingMatrixProcessor::setCurrentProgram(int index) { juce::ignoreUnused(index); }
+const juce::String DuckingMatrixProcessor::getProgramName(int index) { juce::ignoreUnused(index); return {}; }
+void DuckingMatrixProcessor::changeProgramName(int index, const juce::String& newName) { juce::ignoreUnused(index, newName); }
+
+void DuckingMatrixProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
+{
+    matrix.prepare(sampleRate, samplesPerBlock, numKeys, numStems);
+
+    // Key lanes are configured from scratch by the next updateMatrix()
+    for (auto& key : appliedKeys)
+        key.threshold = std::numeric_limits<float>::quiet_NaN();
+
+    keyBuffer.setSize(numKeys, samplesPerBlock);
+    for (auto& stem : stemBuffers)
+        stem.setSize(2, samplesPerBlock);
+
+    updateMatrix();
+    setLatencySamples(matrix.getLatencyInSamples());
+}
+
+void DuckingMatrixProcessor::releaseResources()
+{
+    matrix.reset();
+}
+
+bool DuckingMatrixProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    auto isMonoOrStereo = [](const juce::AudioChannelSet& set)
+    {
+        return set == juce::AudioChannelSet::mono() || set == juce::AudioChannelSet::stereo();
+    };
+
+    // Each stem's input and output must match; stem 1 (main) must be active
+    for (int s = 0; s < numStems; ++s)
+    {
+        auto in = layouts.getChannelSet(true, getStemInputBus(s));
+        auto out = layouts.getChannelSet(false, getStemOutputBus(s));
+
+        if (in != out || (!isMonoOrStereo(out) && (s == 0 || !out.isDisabled())))
+            return false;
+    }
+
+    // Keys can be mono or stereo (or disabled)
+    for (int k = 0; k < numKeys; ++k)
+    {
+        auto key = layouts.getChannelSet(true, getKeyInputBus(k));
+        if (!key.isDisabled() && !isMonoOrStereo(key))
+            return false;
+    }
+
+    return true;
+}
+
+void DuckingMatrixProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ignoreUnused(midiMessages);
+    juce::ScopedNoDenormals noDenormals;
+
+    auto numSamples = buffer.getNumSamples();
+
+    // Copy every stem out before any output is written
+    for (int s = 0; s < numStems; ++s)
+    {
+        auto in = getBusBuffer(buffer, true, getStemInputBus(s));
+        auto& stem = stemBuffers[(size_t)s];
+        stem.setSize(2, numSamples, false, false, true);
+
+        auto numChannels = juce::jmin(in.getNumChannels(), stem.getNumChannels());
+        for (int ch = 0; ch < numChannels; ++ch)
+            stem.copyFrom(ch, 0, in, ch, 0, numSamples);
+
+        stemViews[(size_t)s].setDataToReferTo(stem.getArrayOfWritePointers(), numChannels, numSamples);
+    }
+
+    if (bypass->load() < 0.5f)
+    {
+        // Mono keys; a disabled key bus is silence and never triggers
+        keyBuffer.setSize(numKeys, numSamples, false, false, true);
+        for (int k = 0; k < numKeys; ++k)
+        {
+            auto bus = getBusBuffer(buffer, true, getKeyInputBus(k));
+            auto* key = keyBuffer.getWritePointer(k);
+
+            if (bus.getNumChannels() == 0)
+            {
+                juce::FloatVectorOperations::clear(key, numSamples);
+                continue;
+            }
+
+            juce::FloatVectorOperations::copy(key, bus.getReadPointer(0), numSamples);
+            for (int ch = 1; ch < bus.getNumChannels(); ++ch)
+                juce::FloatVectorOperations::add(key, bus.getReadPointer(ch), numSamples);
+            if (bus.getNumChannels() > 1)
+                juce::FloatVectorOperations::multiply(key, 1.0f / (float)bus.getNumChannels(), numSamples);
+        }
+
+        updateMatrix();
+        setLatencySamples(matrix.getLatencyInSamples());
+
+        matrix.process(keyBuffer.getArrayOfReadPointers(), stemPointers.data(), numSamples);
+    }
+
+    for (int s = 0; s < numStems; ++s)
+    {
+        auto out = getBusBuffer(buffer, false, getStemOutputBus(s));
+        const auto& stem = stemViews[(size_t)s];
+
+        for (int ch = 0; ch < out.getNumChannels(); ++ch)
+        {
+            if (ch < stem.getNumChannels())
+                out.copyFrom(ch, 0, stem, ch, 0, numSamples);
+            else
+                out.clear(ch, 0, numSamples);
+        }
+    }
+}
+
+void DuckingMatrixProcessor::updateMatrix()
+{
+    for (int k = 0; k < numKeys; ++k)
+    {
+        const auto& p = keyParameters[(size_t)k];
+        DuckingMatrix::KeySettings settings;
+        settings.threshold = p.threshold->load();
+        settings.attack = p.attack->load();
+        settings.hold = p.hold->load();
+        settings.release = p.release->load();
+        settings.curveShape = static_cast<int>(p.curveShape->load());
+        settings.hpfEnabled = p.hpfEnabled->load() > 0.5f;
+        settings.hpfFreq = p.hpfFreq->load();
+
+        // setKey recomputes the key's filter coefficients, so only on change
+        auto& applied = appliedKeys[(size_t)k];
+        if (settings.threshold != applied.threshold || settings.attack != applied.attack
+            || settings.hold != applied.hold || settings.release != applied.release
+            || settings.curveShape != applied.curveShape || settings.hpfEnabled != applied.hpfEnabled
+            || settings.hpfFreq != applied.hpfFreq)
+        {
+            matrix.setKey(k, settings);
+            applied = settings;
+        }
+
+        for (int s = 0; s < numStems; ++s)
+            matrix.setDepth(k, s, depth[(size_t)k][(size_t)s]->load());
+    }
+
+    for (int s = 0; s < numStems; ++s)
+        matrix.setTarget(s, { stemParameters[(size_t)s].range->load(), stemParameters[(size_t)s].mix->load() });
+
+    matrix.setLookAhead(lookAhead->load());
+}
+
+bool DuckingMatrixProcessor::hasEditor() const
+{
+    return true;
+}
+
+juce::AudioProcessorEditor* DuckingMatrixProcessor::createEditor()
+{
+    return new juce::GenericAudioProcessorEditor(*this);
+}
+
+void DuckingMatrixProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    auto state = apvts.copyState();
+    std::unique_ptr<juce::XmlElement> xml(state.createXml());
+    copyXmlToBinary(*xml, destData);
+}
+
+void DuckingMatrixProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
+    if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+        apvts.replaceState(juce::ValueTree::fromXml(*xml));
+}
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new DuckingMatrixProcessor();
+}
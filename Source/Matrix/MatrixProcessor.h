@@ -0,0 +1,101 @@
+#pragma once
+
+#include <juce_audio_processors/juce_audio_processors.h>
+#include "DSP/DuckingMatrix.h"
+
+// Ducker Matrix - the DuckingMatrix as a plugin: several keys ducking
+// several stems from one instance, e.g. dialogue ducks music by 12 dB and
+// SFX by 4 dB while the announcer ducks everything.
+//
+// Buses: the main input/output pair is stem 1 and input bus 1 is key 1, so
+// it works as a plain sidechain ducker in any host. Keys 2-4 and stems 2-4
+// are optional buses the host can enable (stem N's input and output must
+// match). Keys are downmixed to mono; a disabled key bus is silence.
+//
+// Every cell (key -> stem) has its own depth, 0 dB meaning "does not duck".
+// Detection settings are per key, range and mix per stem, and the look-ahead
+// is shared so all stems stay aligned.
+class DuckingMatrixProcessor : public juce::AudioProcessor
+{
+public:
+    static constexpr int numKeys = 4;
+    static constexpr int numStems = 4;
+
+    DuckingMatrixProcessor();
+    ~DuckingMatrixProcessor() override = default;
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    using AudioProcessor::processBlock;
+
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    const juce::String getName() const override;
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram(int index) override;
+    const juce::String getProgramName(int index) override;
+    void changeProgramName(int index, const juce::String& newName) override;
+
+    void getStateInformation(juce::MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+    juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
+
+    // Bus indices: inputs are stem 1, keys 1-4, then stems 2-4
+    static int getKeyInputBus(int key) { return 1 + key; }
+    static int getStemInputBus(int stem) { return stem == 0 ? 0 : numKeys + stem; }
+    static int getStemOutputBus(int stem) { return stem; }
+
+private:
+    juce::AudioProcessorValueTreeState apvts;
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
+
+    void updateMatrix();
+
+    DuckingMatrix matrix;
+
+    // Mono key signals, and each stem's input copied out of the host buffer
+    // (an output bus can share channels with a different bus's input)
+    juce::AudioBuffer<float> keyBuffer;
+    std::array<juce::AudioBuffer<float>, numStems> stemBuffers;
+    std::array<juce::AudioBuffer<float>, numStems> stemViews;
+    std::array<juce::AudioBuffer<float>*, numStems> stemPointers {};
+
+    // Key settings last handed to the matrix (setKey recomputes filters)
+    std::array<DuckingMatrix::KeySettings, numKeys> appliedKeys {};
+
+    // Parameter pointers (cached for fast access)
+    struct KeyParameters
+    {
+        std::atomic<float>* threshold = nullptr;
+        std::atomic<float>* attack = nullptr;
+        std::atomic<float>* hold = nullptr;
+        std::atomic<float>* release = nullptr;
+        std::atomic<float>* curveShape = nullptr;
+        std::atomic<float>* hpfEnabled = nullptr;
+        std::atomic<float>* hpfFreq = nullptr;
+    };
+
+    struct StemParameters
+    {
+        std::atomic<float>* range = nullptr;
+        std::atomic<float>* mix = nullptr;
+    };
+
+    std::array<KeyParameters, numKeys> keyParameters;
+    std::array<StemParameters, numStems> stemParameters;
+    std::array<std::array<std::atomic<float>*, numStems>, numKeys> depth {};
+    std::atomic<float>* lookAhead = nullptr;
+    std::atomic<float>* bypass = nullptr;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DuckingMatrixProcessor)
+};
@@ -0,0 +1,402 @@
+#include "CachedRenderer.h"
+
+namespace
+{
+    constexpr int cacheVersion = 1;
+
+    // Fast non-cryptographic 64-bit hash, fed in 8-byte words
+    struct Hash64
+    {
+        juce::uint64 value = 0x243f6a8885a308d3ull;
+
+        void add(juce::uint64 word)
+        {
+            value ^= word * 0x9e3779b97f4a7c15ull;
+            value = ((value << 31) | (value >> 33)) * 0xff51afd7ed558ccdull;
+        }
+
+        void add(const float* data, int numSamples)
+        {
+            int i = 0;
+            for (; i + 1 < numSamples; i += 2)
+            {
+                juce::uint64 word;
+                std::memcpy(&word, data + i, sizeof(word));
+                add(word);
+            }
+
+            if (i < numSamples)
+            {
+                juce::uint32 last;
+                std::memcpy(&last, data + i, sizeof(last));
+                add((juce::uint64)last);
+            }
+
+            add((juce::uint64)numSamples);
+        }
+
+        void add(float f)  { add((juce::uint64)juce::roundToIntAccurate((double)f * 1.0e4)); }
+
+        juce::uint64 get() const
+        {
+            auto h = value;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ull;
+            h ^= h >> 33;
+            return h;
+        }
+    };
+
+    struct DetectorState
+    {
+        EnvelopeGenerator::Snapshot envelope;
+        SidechainProcessor::Snapshot filter;
+
+        void write(juce::OutputStream& out) const
+        {
+            out.writeInt(envelope.state);
+            out.writeFloat(envelope.envelope);
+            out.writeInt(envelope.holdCounter);
+            out.writeBool(envelope.triggered);
+            for (auto v : filter.state)
+                out.writeFloat(v);
+        }
+
+        void read(juce::InputStream& in)
+        {
+            envelope.state = in.readInt();
+            envelope.envelope = in.readFloat();
+            envelope.holdCounter = in.readInt();
+            envelope.triggered = in.readBool();
+            for (auto& v : filter.state)
+                v = in.readFloat();
+        }
+    };
+
+    // Only what affects future gains, quantised so that settled state matches
+    juce::uint64 hashState(const DetectorState& s, const DuckerSettings& settings)
+    {
+        Hash64 h;
+        h.add((juce::uint64)s.envelope.state);
+
+        // Idle always restarts from zero; the counter only matters before release
+        if (s.envelope.state != 0)
+            h.add((juce::uint64)juce::roundToIntAccurate((double)s.envelope.envelope * 1.0e6));
+        if (s.envelope.state == 1 || s.envelope.state == 2)
+            h.add((juce::uint64)s.envelope.holdCounter);
+
+        // Left-channel filter state; processSample never touches the right
+        auto addFilter = [&](int offset)
+        {
+            for (int i = offset; i < offset + 4; ++i)
+                h.add((juce::uint64)std::llround((double)s.filter.state[(size_t)i] * 1.0e7));
+        };
+
+        if (settings.scHPFEnabled)
+            addFilter(0);
+        if (settings.scLPFEnabled)
+            addFilter(8);
+
+        return h.get();
+    }
+
+    juce::uint64 hashParameters(const DuckerSettings& s, double sampleRate, int chunkSize)
+    {
+        Hash64 h;
+        h.add((juce::uint64)cacheVersion);
+        h.add((juce::uint64)chunkSize);
+        h.add((juce::uint64)juce::roundToInt(sampleRate));
+        h.add(s.threshold);
+        h.add(s.attack);
+        h.add(s.getHoldMs());
+        h.add(s.getReleaseMs());
+        h.add(s.duckAmount);
+        h.add(s.range);
+        h.add(s.mix);
+        h.add((juce::uint64)s.curveShape);
+        h.add((juce::uint64)(s.scHPFEnabled ? 1 : 0));
+        h.add((juce::uint64)(s.scLPFEnabled ? 1 : 0));
+        if (s.scHPFEnabled)
+            h.add(s.scHPFFreq);
+        if (s.scLPFEnabled)
+            h.add(s.scLPFFreq);
+        return h.get();
+    }
+
+    // Detection stage of Ducker::process with zero-crossing off: the gain
+    // applied to each key-time sample, mix included, at .dgain resolution
+    class Detector
+    {
+    public:
+        Detector(const DuckerSettings& s, double sampleRate, int blockSize)
+        {
+            filter.prepare(sampleRate, blockSize);
+            filter.setHighPassFreq(s.scHPFFreq);
+            filter.setLowPassFreq(s.scLPFFreq);
+            filter.setHighPassEnabled(s.scHPFEnabled);
+            filter.setLowPassEnabled(s.scLPFEnabled);
+
+            envelope.prepare(sampleRate, blockSize);
+            envelope.setThreshold(s.threshold);
+            envelope.setAttack(s.attack);
+            envelope.setHold(s.getHoldMs());
+            envelope.setRelease(s.getReleaseMs());
+            envelope.setCurveShape(static_cast<DSPUtils::CurveShape>(s.curveShape));
+
+            duckedGain = std::max(DSPUtils::decibelsToLinear(s.duckAmount), DSPUtils::decibelsToLinear(s.range));
+            wetMix = s.mix / 100.0f;
+            dryMix = 1.0f - wetMix;
+        }
+
+        void process(const float* key, float* gains, int numSamples)
+        {
+            for (int i = 0; i < numSamples; ++i)
+            {
+                float env = envelope.processSample(filter.processSample(key[i]));
+                float gain = dryMix + (1.0f - env * (1.0f - duckedGain)) * wetMix;
+
+                // Requantise only when the step changes
+                auto steps = GainTrack::toSteps(gain);
+                if (steps != lastSteps)
+                {
+                    lastSteps = steps;
+                    lastGain = GainTrack::fromSteps(steps);
+                }
+
+                gains[i] = lastGain;
+            }
+        }
+
+        DetectorState getState() const { return { envelope.getSnapshot(), filter.getSnapshot() }; }
+
+        void setState(const DetectorState& state)
+        {
+            envelope.restoreSnapshot(state.envelope);
+            filter.restoreSnapshot(state.filter);
+        }
+
+    private:
+        SidechainProcessor filter;
+        EnvelopeGenerator envelope;
+        float duckedGain = 1.0f, wetMix = 1.0f, dryMix = 0.0f;
+        int lastSteps = 0;
+        float lastGain = 1.0f;
+    };
+
+    bool loadChunk(const juce::File& file, int numSamples, float* gains, DetectorState& exitState)
+    {
+        auto fileStream = file.createInputStream();
+        if (fileStream == nullptr)
+            return false;
+
+        auto stream = std::make_unique<juce::BufferedInputStream>(fileStream.release(), 1 << 15, true);
+        if (stream->readInt() != cacheVersion)
+            return false;
+
+        exitState.read(*stream);
+
+        GainTrackReader reader;
+        juce::String error;
+        return reader.open(std::move(stream), error)
+            && reader.getLengthInSamples() == numSamples
+            && reader.read(gains, numSamples) == numSamples;
+    }
+
+    void storeChunk(const juce::File& file, double sampleRate, const float* gains, int numSamples,
+                    const DetectorState& exitState)
+    {
+        // Write to a temporary name and rename, so parallel jobs never see
+        // a partial chunk
+        auto temp = file.getSiblingFile(file.getFileName() + "." + juce::Uuid().toString());
+
+        {
+            auto stream = std::make_unique<juce::FileOutputStream>(temp);
+            if (stream->failedToOpen())
+                return;
+
+            stream->writeInt(cacheVersion);
+            exitState.write(*stream);
+
+            GainTrackWriter writer;
+            writer.open(std::move(stream), sampleRate);
+            writer.write(gains, numSamples);
+            if (!writer.finish())
+            {
+                temp.deleteFile();
+                return;
+            }
+        }
+
+        if (!temp.moveFileTo(file))
+            temp.deleteFile();
+    }
+}
+
+//==============================================================================
+CachedRenderer::CachedRenderer(const OfflineRenderer& r, const juce::File& dir, int chunk)
+    : renderer(r), cacheDirectory(dir), chunkSize(juce::jmax(1024, chunk))
+{
+    cacheDirectory.createDirectory();
+}
+
+CachedRenderResult CachedRenderer::render(const RenderJob& job) const
+{
+    const auto& settings = renderer.getSettings();
+    CachedRenderResult result;
+
+    if (settings.zeroCrossing || settings.scListen)
+    {
+        static_cast<RenderResult&>(result) = renderer.render(job);
+        result.cacheBypassed = true;
+        return result;
+    }
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    RenderSources sources;
+    if (!renderer.openSources(sources, job, result.error))
+        return result;
+
+    auto sampleRate = sources.getSampleRate();
+    auto numChannels = sources.getNumChannels();
+    auto length = sources.getLengthInSamples();
+    auto parameterHash = hashParameters(settings, sampleRate, chunkSize);
+
+    // Same rounding as Ducker::updateLookAhead
+    auto latency = (juce::int64)static_cast<int>(settings.lookAhead * 0.001f * sampleRate);
+
+    auto output = renderer.createOutput(job.outputFile, sampleRate, numChannels, result.error);
+    if (output == nullptr)
+        return result;
+
+    Detector detector(settings, sampleRate, chunkSize);
+
+    juce::AudioBuffer<float> scBuffer(2, chunkSize);
+    juce::AudioBuffer<float> mainBuffer(numChannels, chunkSize);
+    juce::HeapBlock<float> gains((size_t)chunkSize);
+
+    // Key-time gains for [pos, pos + n) apply to main samples [pos - latency, ...)
+    auto applyAndWrite = [&](juce::int64 keyPos, int n)
+    {
+        auto mainStart = keyPos - latency;
+        auto first = (int)juce::jmax((juce::int64)0, -mainStart);
+        auto last = (int)juce::jmin((juce::int64)n, length - mainStart);
+        if (last <= first)
+            return;
+
+        mainBuffer.setSize(numChannels, n, false, false, true);
+        sources.main->read(&mainBuffer, 0, n, mainStart, true, numChannels > 1);
+        Ducker::applyGainCurve(mainBuffer, gains + first, first, last - first);
+        output->write(mainBuffer, first, last - first);
+    };
+
+    auto readKey = [&](juce::int64 pos, int n)
+    {
+        // Same downmix as Ducker::process (reads past the end are silent)
+        if (sources.sidechain != nullptr)
+            sources.sidechain->read(&scBuffer, 0, n, pos, true, true);
+        else
+        {
+            sources.main->read(&scBuffer, 0, n, pos, true, numChannels > 1);
+            if (numChannels == 1)
+                scBuffer.copyFrom(1, 0, scBuffer, 0, 0, n);
+        }
+
+        auto* mono = scBuffer.getWritePointer(0);
+        juce::FloatVectorOperations::add(mono, scBuffer.getReadPointer(1), n);
+        juce::FloatVectorOperations::multiply(mono, 0.5f, n);
+        return mono;
+    };
+
+    for (juce::int64 pos = 0; pos < length; pos += chunkSize)
+    {
+        auto n = (int)juce::jmin((juce::int64)chunkSize, length - pos);
+        auto* key = readKey(pos, n);
+
+        Hash64 chunkHash;
+        chunkHash.add(parameterHash);
+        chunkHash.add(hashState(detector.getState(), settings));
+        chunkHash.add(key, n);
+
+        auto chunkFile = cacheDirectory.getChildFile(juce::String::toHexString((juce::int64)chunkHash.get())
+                                                     .paddedLeft('0', 16) + ".dchunk");
+
+        DetectorState exitState;
+        if (loadChunk(chunkFile, n, gains, exitState))
+        {
+            detector.setState(exitState);
+            chunkFile.setLastModificationTime(juce::Time::getCurrentTime());   // for prune()
+            ++result.chunksReused;
+        }
+        else
+        {
+            detector.process(key, gains, n);
+            storeChunk(chunkFile, sampleRate, gains, n, detector.getState());
+            ++result.chunksComputed;
+        }
+
+        applyAndWrite(pos, n);
+    }
+
+    // The last latency samples of main need gains from past the end of the
+    // key; that tail is always computed
+    for (juce::int64 pos = length; pos < length + latency; pos += chunkSize)
+    {
+        auto n = (int)juce::jmin((juce::int64)chunkSize, length + latency - pos);
+        auto* key = readKey(pos, n);
+        detector.process(key, gains, n);
+        applyAndWrite(pos, n);
+    }
+
+    output.reset(); // flush and close
+
+    result.ok = true;
+    result.audioSeconds = (double)length / sampleRate;
+    result.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    return result;
+}
+
+int CachedRenderer::prune(const juce::File& cacheDirectory, juce::int64 maxBytes)
+{
+    struct Entry
+    {
+        juce::File file;
+        juce::int64 size;
+        juce::Time lastUsed;
+    };
+
+    std::vector<Entry> entries;
+    juce::int64 totalBytes = 0;
+    int removed = 0;
+
+    for (const auto& item : juce::RangedDirectoryIterator(cacheDirectory, false, "*.dchunk*", juce::File::findFiles))
+    {
+        auto file = item.getFile();
+
+        // "<hash>.dchunk.<uuid>": a write that never got renamed
+        if (file.getFileExtension() != ".dchunk")
+        {
+            removed += file.deleteFile() ? 1 : 0;
+            continue;
+        }
+
+        entries.push_back({ file, item.getFileSize(), item.getModificationTime() });
+        totalBytes += item.getFileSize();
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.lastUsed < b.lastUsed; });
+
+    for (auto& entry : entries)
+    {
+        if (totalBytes <= maxBytes)
+            break;
+
+        if (entry.file.deleteFile())
+        {
+            totalBytes -= entry.size;
+            ++removed;
+        }
+    }
+
+    return removed;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "OfflineRenderer.h"
+
+struct CachedRenderResult : RenderResult
+{
+    int chunksReused = 0;
+    int chunksComputed = 0;
+    bool cacheBypassed = false;    // settings the cache cannot represent
+};
+
+// Incremental re-rendering backed by an on-disk chunk cache.
+//
+// Detection (sidechain downmix, filters, envelope, gain mapping) runs in
+// fixed chunks of key time. Each chunk is looked up by a hash of its key
+// audio, the detection parameters and the detector state at its start.
+// A hit restores the cached gains and end-of-chunk state, and a miss
+// computes and stores them. An edit therefore recomputes its own chunks
+// plus the following ones until the detector state matches a cached run
+// again, which happens once the envelope has returned to idle and the
+// filters have settled. State is hashed at 1e-6 (envelope) / 1e-7
+// (filters) resolution so that settled state matches.
+//
+// The main signal never enters the hash, so remixing the main stems
+// reuses every chunk, and look-ahead is applied afterwards. Gains are held
+// at the .dgain resolution (0.01 dB) on both paths. Because the state is
+// quantised, a reused chunk may have been computed from a very slightly
+// different state: its gains match an uncached render to within one 0.01 dB
+// step, except where that difference moves a threshold crossing by a
+// sample or so. Zero-crossing gating and sidechain listen depend on the
+// main signal; with either enabled the job falls back to a normal render.
+//
+// Boundaries are at fixed sample positions, so an edit that inserts or
+// removes time invalidates every chunk after it.
+//
+// Reused chunks are touched, so prune() can trim the directory to a size
+// limit by dropping the least recently used chunks first.
+class CachedRenderer
+{
+public:
+    CachedRenderer(const OfflineRenderer& renderer, const juce::File& cacheDirectory, int chunkSize = 1 << 16);
+
+    CachedRenderResult render(const RenderJob& job) const;
+
+    // Deletes least recently used chunks until the directory holds at most
+    // maxBytes, plus temporaries left by interrupted writes. Call it when no
+    // render is using the directory. Returns the number of files removed.
+    static int prune(const juce::File& cacheDirectory, juce::int64 maxBytes);
+
+private:
+    const OfflineRenderer& renderer;
+    juce::File cacheDirectory;
+    int chunkSize;
+};
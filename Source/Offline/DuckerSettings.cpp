@@ -0,0 +1,90 @@
+#include "DuckerSettings.h"
+
+bool DuckerSettings::setParameter(const juce::String& id, double value)
+{
+    auto f = static_cast<float>(value);
+    auto b = value > 0.5;
+    auto i = juce::roundToInt(value);
+
+    if (id == "threshold")          threshold = f;
+    else if (id == "duckAmount")    duckAmount = f;
+    else if (id == "attack")        attack = f;
+    else if (id == "hold")          hold = f;
+    else if (id == "release")       release = f;
+    else if (id == "range")         range = f;
+    else if (id == "lookAhead")     lookAhead = juce::jlimit(0.0f, 20.0f, f);
+    else if (id == "curveShape")    curveShape = juce::jlimit(0, 3, i);
+    else if (id == "mix")           mix = f;
+    else if (id == "scHPFFreq")     scHPFFreq = f;
+    else if (id == "scLPFFreq")     scLPFFreq = f;
+    else if (id == "scHPFEnabled")  scHPFEnabled = b;
+    else if (id == "scLPFEnabled")  scLPFEnabled = b;
+    else if (id == "scListen")      scListen = b;
+    else if (id == "zeroCrossing")  zeroCrossing = b;
+    else if (id == "tempoSync")     tempoSync = b;
+    else if (id == "holdSync")      holdSync = juce::jlimit(0, DSPUtils::numSyncDivisions - 1, i);
+    else if (id == "releaseSync")   releaseSync = juce::jlimit(0, DSPUtils::numSyncDivisions - 1, i);
+    else if (id == "bpm")           bpm = value;
+    else if (id == "bypass")        {}
+    else                            return false;
+
+    return true;
+}
+
+bool DuckerSettings::setFromString(const juce::String& assignment)
+{
+    if (!assignment.containsChar('='))
+        return false;
+
+    return setParameter(assignment.upToFirstOccurrenceOf("=", false, false).trim(),
+                        assignment.fromFirstOccurrenceOf("=", false, false).trim().getDoubleValue());
+}
+
+bool DuckerSettings::loadPreset(const juce::File& file, juce::String& error)
+{
+    auto xml = juce::XmlDocument::parse(file);
+    if (xml == nullptr)
+    {
+        error = "Could not parse preset " + file.getFullPathName();
+        return false;
+    }
+
+    for (auto* param : xml->getChildWithTagNameIterator("PARAM"))
+        setParameter(param->getStringAttribute("id"), param->getDoubleAttribute("value"));
+
+    return true;
+}
+
+float DuckerSettings::getHoldMs() const
+{
+    if (tempoSync && bpm > 0.0)
+        return static_cast<float>(60000.0 / bpm * DSPUtils::getSyncDivisionBeats(holdSync));
+    return hold;
+}
+
+float DuckerSettings::getReleaseMs() const
+{
+    if (tempoSync && bpm > 0.0)
+        return static_cast<float>(60000.0 / bpm * DSPUtils::getSyncDivisionBeats(releaseSync));
+    return release;
+}
+
+void DuckerSettings::applyTo(Ducker& ducker) const
+{
+    ducker.setThreshold(threshold);
+    ducker.setDuckAmount(duckAmount);
+    ducker.setAttack(attack);
+    ducker.setHold(getHoldMs());
+    ducker.setRelease(getReleaseMs());
+    ducker.setRange(range);
+    ducker.setLookAhead(lookAhead);
+    ducker.setCurveShape(curveShape);
+    ducker.setMix(mix);
+
+    ducker.setSidechainHPF(scHPFFreq);
+    ducker.setSidechainLPF(scLPFFreq);
+    ducker.setSidechainHPFEnabled(scHPFEnabled);
+    ducker.setSidechainLPFEnabled(scLPFEnabled);
+    ducker.setSidechainListen(scListen);
+    ducker.setZeroCrossingEnabled(zeroCrossing);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+#include "../DSP/Ducker.h"
+
+// Plain snapshot of every Ducker parameter, for headless rendering.
+// Defaults and IDs match the plugin's AudioProcessorValueTreeState layout,
+// so a preset saved from the plugin state (<Parameters><PARAM id value/>)
+// can be loaded directly.
+struct DuckerSettings
+{
+    float threshold = -20.0f;      // dB
+    float duckAmount = -20.0f;     // dB
+    float attack = 10.0f;          // ms
+    float hold = 50.0f;            // ms
+    float release = 200.0f;        // ms
+    float range = -40.0f;          // dB
+    float lookAhead = 5.0f;        // ms
+    int curveShape = 0;
+    float mix = 100.0f;            // %
+
+    float scHPFFreq = 80.0f;       // Hz
+    float scLPFFreq = 12000.0f;    // Hz
+    bool scHPFEnabled = false;
+    bool scLPFEnabled = false;
+    bool scListen = false;
+    bool zeroCrossing = false;
+
+    // Tempo sync needs a tempo, since there is no host offline
+    bool tempoSync = false;
+    int holdSync = 3;
+    int releaseSync = 5;
+    double bpm = 0.0;
+
+    // Set a parameter by its plugin ID. Returns false for unknown IDs.
+    bool setParameter(const juce::String& id, double value);
+
+    // Parse "id=value"
+    bool setFromString(const juce::String& assignment);
+
+    // Load a plugin state XML file. Unknown PARAM ids are ignored.
+    bool loadPreset(const juce::File& file, juce::String& error);
+
+    float getHoldMs() const;
+    float getReleaseMs() const;
+
+    void applyTo(Ducker& ducker) const;
+};
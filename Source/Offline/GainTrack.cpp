@@ -0,0 +1,208 @@
+#include "GainTrack.h"
+
+namespace
+{
+    const char magic[4] = { 'D', 'K', 'G', 'T' };
+
+    juce::uint64 zigzag(juce::int64 v)  { return ((juce::uint64)v << 1) ^ (juce::uint64)(v >> 63); }
+    juce::int64 unzigzag(juce::uint64 v) { return (juce::int64)(v >> 1) ^ -(juce::int64)(v & 1); }
+}
+
+int GainTrack::toSteps(float gain)
+{
+    auto db = gain > 0.0f ? 20.0f * std::log10(gain) : floorDb;
+    return juce::roundToInt(juce::jmax(floorDb, db) / stepDb);
+}
+
+float GainTrack::fromSteps(int steps, float step)
+{
+    return std::pow(10.0f, (float)steps * step / 20.0f);
+}
+
+//==============================================================================
+bool GainTrackWriter::open(const juce::File& file, double sampleRate, juce::String& error)
+{
+    file.deleteFile();
+    auto fileStream = std::make_unique<juce::FileOutputStream>(file);
+    if (fileStream->failedToOpen())
+    {
+        error = "Could not write " + file.getFullPathName();
+        return false;
+    }
+
+    open(std::move(fileStream), sampleRate);
+    return true;
+}
+
+void GainTrackWriter::open(std::unique_ptr<juce::OutputStream> newStream, double sampleRate)
+{
+    stream = std::move(newStream);
+
+    stream->write(magic, sizeof(magic));
+    stream->writeInt(GainTrack::version);
+    stream->writeDouble(sampleRate);
+    lengthPosition = stream->getPosition();
+    stream->writeInt64(0);
+    stream->writeFloat(GainTrack::stepDb);
+
+    numSamplesWritten = 0;
+    previous = 0;   // unity
+    pendingRun = 0;
+}
+
+GainTrackWriter::~GainTrackWriter()
+{
+    finish();
+}
+
+void GainTrackWriter::write(const float* gains, int numSamples)
+{
+    if (stream == nullptr)
+        return;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        auto q = GainTrack::toSteps(gains[i]);
+        if (q == previous)
+        {
+            ++pendingRun;
+            continue;
+        }
+
+        flushRun();
+        writeVarint(zigzag(q - previous));
+        previous = q;
+    }
+
+    numSamplesWritten += numSamples;
+}
+
+bool GainTrackWriter::finish()
+{
+    if (stream == nullptr)
+        return false;
+
+    flushRun();
+
+    auto end = stream->getPosition();
+    bool ok = stream->setPosition(lengthPosition);
+    stream->writeInt64(numSamplesWritten);
+    ok = ok && stream->setPosition(end);
+    stream->flush();
+
+    if (auto* fileStream = dynamic_cast<juce::FileOutputStream*>(stream.get()))
+        ok = ok && fileStream->getStatus().wasOk();
+
+    stream.reset();
+    return ok;
+}
+
+void GainTrackWriter::flushRun()
+{
+    if (pendingRun == 0)
+        return;
+
+    writeVarint(0);
+    writeVarint(pendingRun - 1);
+    pendingRun = 0;
+}
+
+void GainTrackWriter::writeVarint(juce::uint64 value)
+{
+    while (value >= 0x80)
+    {
+        stream->writeByte((char)((value & 0x7f) | 0x80));
+        value >>= 7;
+    }
+
+    stream->writeByte((char)value);
+}
+
+//==============================================================================
+bool GainTrackReader::open(const juce::File& file, juce::String& error)
+{
+    auto fileStream = file.createInputStream();
+    if (fileStream == nullptr)
+    {
+        error = "Could not open " + file.getFullPathName();
+        return false;
+    }
+
+    if (open(std::make_unique<juce::BufferedInputStream>(fileStream.release(), 1 << 16, true), error))
+        return true;
+
+    error = file.getFileName() + ": " + error;
+    return false;
+}
+
+bool GainTrackReader::open(std::unique_ptr<juce::InputStream> newStream, juce::String& error)
+{
+    stream = std::move(newStream);
+
+    char header[4] = {};
+    stream->read(header, sizeof(header));
+    if (std::memcmp(header, magic, sizeof(magic)) != 0 || stream->readInt() != GainTrack::version)
+    {
+        error = "Not a gain track";
+        return false;
+    }
+
+    sampleRate = stream->readDouble();
+    lengthInSamples = stream->readInt64();
+    step = stream->readFloat();
+
+    position = 0;
+    current = 0;
+    remainingRun = 0;
+    return true;
+}
+
+int GainTrackReader::read(float* gains, int numSamples)
+{
+    auto available = (int)juce::jlimit((juce::int64)0, (juce::int64)numSamples, lengthInSamples - position);
+    float currentGain = GainTrack::fromSteps(current, step);
+
+    for (int i = 0; i < available; ++i)
+    {
+        if (remainingRun > 0)
+        {
+            --remainingRun;
+        }
+        else
+        {
+            auto delta = unzigzag(readVarint());
+            if (delta == 0)
+            {
+                remainingRun = readVarint();   // this sample plus remainingRun more
+            }
+            else
+            {
+                current += (int)delta;
+                currentGain = GainTrack::fromSteps(current, step);
+            }
+        }
+
+        gains[i] = currentGain;
+    }
+
+    for (int i = available; i < numSamples; ++i)
+        gains[i] = 1.0f;
+
+    position += available;
+    return available;
+}
+
+juce::uint64 GainTrackReader::readVarint()
+{
+    juce::uint64 value = 0;
+
+    for (int shift = 0; shift < 64 && !stream->isExhausted(); shift += 7)
+    {
+        auto byte = (juce::uint8)stream->readByte();
+        value |= (juce::uint64)(byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0)
+            break;
+    }
+
+    return value;
+}
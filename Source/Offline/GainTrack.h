@@ -0,0 +1,77 @@
+#pragma once
+
+#include <juce_core/juce_core.h>
+
+// Sidecar file holding a per-sample gain track, so a finished ducking pass
+// can be replayed onto other material without running detection again.
+//
+// Gains are stored in dB quantised to 0.01 dB (clamped to -120 dB), as
+// zigzag varint deltas between consecutive samples. A zero delta is followed
+// by a varint run length, so steady stretches (unducked, or held at full
+// depth) cost a few bytes however long they are.
+//
+// Layout: "DKGT", version (int32), sample rate (double), length (int64),
+// step in dB (float), then the encoded stream. All little-endian.
+namespace GainTrack
+{
+    constexpr float stepDb = 0.01f;
+    constexpr float floorDb = -120.0f;
+    constexpr int version = 1;
+
+    // Quantisation used by the file format
+    int toSteps(float gain);
+    float fromSteps(int steps, float step = stepDb);
+}
+
+class GainTrackWriter
+{
+public:
+    bool open(const juce::File& file, double sampleRate, juce::String& error);
+
+    // Writes at the stream's current position, which must be seekable
+    void open(std::unique_ptr<juce::OutputStream> stream, double sampleRate);
+
+    void write(const float* gains, int numSamples);
+
+    // Flushes the pending run and patches the length into the header
+    bool finish();
+
+    ~GainTrackWriter();
+
+private:
+    void writeVarint(juce::uint64 value);
+    void flushRun();
+
+    std::unique_ptr<juce::OutputStream> stream;
+    juce::int64 lengthPosition = 0;
+    juce::int64 numSamplesWritten = 0;
+    int previous = 0;
+    juce::uint64 pendingRun = 0;
+};
+
+class GainTrackReader
+{
+public:
+    bool open(const juce::File& file, juce::String& error);
+
+    // Reads from the stream's current position
+    bool open(std::unique_ptr<juce::InputStream> stream, juce::String& error);
+
+    // Decodes the next numSamples linear gains. Past the end of the track
+    // the gain is unity. Returns the number of samples actually decoded.
+    int read(float* gains, int numSamples);
+
+    double getSampleRate() const { return sampleRate; }
+    juce::int64 getLengthInSamples() const { return lengthInSamples; }
+
+private:
+    juce::uint64 readVarint();
+
+    std::unique_ptr<juce::InputStream> stream;
+    double sampleRate = 0.0;
+    juce::int64 lengthInSamples = 0;
+    juce::int64 position = 0;
+    float step = GainTrack::stepDb;
+    int current = 0;
+    juce::uint64 remainingRun = 0;
+};
@@ -0,0 +1,283 @@
+#include "NonCausalRenderer.h"
+
+juce::int64 TriggerTrack::getTriggeredSamples() const
+{
+    juce::int64 total = 0;
+    for (auto& region : regions)
+        total += region.getLength();
+    return total;
+}
+
+//==============================================================================
+KeyAnalyser::KeyAnalyser(const DuckerSettings& s, int hop, int block)
+    : settings(s), hopSize(juce::jmax(1, hop)), blockSize(juce::jmax(hop, block))
+{
+}
+
+bool KeyAnalyser::analyse(juce::AudioFormatReader& key, TriggerTrack& track, juce::String& error) const
+{
+    if (key.numChannels < 1 || key.sampleRate <= 0.0)
+    {
+        error = "Key stream has no audio";
+        return false;
+    }
+
+    auto numChannels = (int)juce::jmin(2u, key.numChannels);
+
+    SidechainProcessor filter;
+    filter.prepare(key.sampleRate, blockSize);
+    filter.setHighPassFreq(settings.scHPFFreq);
+    filter.setLowPassFreq(settings.scLPFFreq);
+    filter.setHighPassEnabled(settings.scHPFEnabled);
+    filter.setLowPassEnabled(settings.scLPFEnabled);
+    bool filtering = settings.scHPFEnabled || settings.scLPFEnabled;
+
+    // Same test as EnvelopeGenerator: level in dB strictly above threshold
+    auto thresholdLinear = DSPUtils::decibelsToLinear(settings.threshold);
+
+    track = {};
+    track.sampleRate = key.sampleRate;
+    track.lengthInSamples = key.lengthInSamples;
+    track.hopSize = hopSize;
+
+    juce::AudioBuffer<float> buffer(numChannels, blockSize);
+    bool inRegion = false;
+    juce::int64 regionStart = 0;
+
+    for (juce::int64 pos = 0; pos < key.lengthInSamples; pos += blockSize)
+    {
+        auto numSamples = (int)juce::jmin((juce::int64)blockSize, key.lengthInSamples - pos);
+        key.read(&buffer, 0, numSamples, pos, true, numChannels > 1);
+
+        // Mono sum, as the realtime sidechain does
+        auto* mono = buffer.getWritePointer(0);
+        if (numChannels > 1)
+        {
+            juce::FloatVectorOperations::add(mono, buffer.getReadPointer(1), numSamples);
+            juce::FloatVectorOperations::multiply(mono, 0.5f, numSamples);
+        }
+
+        // The biquads are recursive, so this is the one scalar loop
+        if (filtering)
+            for (int i = 0; i < numSamples; ++i)
+                mono[i] = filter.processSample(mono[i]);
+
+        for (int h = 0; h < numSamples; h += hopSize)
+        {
+            auto range = juce::FloatVectorOperations::findMinAndMax(mono + h, juce::jmin(hopSize, numSamples - h));
+            bool hot = juce::jmax(-range.getStart(), range.getEnd()) > thresholdLinear;
+
+            if (hot && !inRegion)
+            {
+                inRegion = true;
+                regionStart = pos + h;
+            }
+            else if (!hot && inRegion)
+            {
+                inRegion = false;
+                track.regions.push_back({ regionStart, pos + h });
+            }
+        }
+    }
+
+    if (inRegion)
+        track.regions.push_back({ regionStart, key.lengthInSamples });
+
+    return true;
+}
+
+//==============================================================================
+class NonCausalRenderer::EnvelopeBuilder
+{
+public:
+    EnvelopeBuilder(std::vector<juce::Range<juce::int64>> activeRegions, float attack, float release, int maxBlockSize)
+        : active(std::move(activeRegions)), attackCoeff(attack), releaseCoeff(release)
+    {
+        // Samples for the backward attack pass to decay below 1e-5
+        margin = attackCoeff >= 1.0f ? 1 : (int)std::ceil(std::log(1.0e5) / -std::log(1.0 - attackCoeff));
+
+        // Each window's backward pass overruns it by the margin; long windows
+        // keep that overrun a small fraction of the work at any attack time
+        window = juce::jmax(maxBlockSize, 4 * margin);
+        scratch.resize((size_t)(window + margin));
+    }
+
+    // Blocks must be requested in order and without gaps
+    void build(juce::int64 start, float* envelope, int numSamples)
+    {
+        while (numSamples > 0)
+        {
+            if (!windowValid || start >= windowStart + window)
+                computeWindow(start);
+
+            auto offset = (int)(start - windowStart);
+            auto n = juce::jmin(numSamples, window - offset);
+            std::copy(scratch.data() + offset, scratch.data() + offset + n, envelope);
+
+            envelope += n;
+            start += n;
+            numSamples -= n;
+        }
+    }
+
+private:
+    void computeWindow(juce::int64 start)
+    {
+        windowStart = start;
+        windowValid = true;
+
+        auto total = window + margin;
+        auto* data = scratch.data();
+
+        // Nothing active up to the end of the margin and the release has
+        // died away: the whole window is silent
+        if (!fillTarget(start, data, total) && forwardState < 1.0e-5f)
+        {
+            forwardState = 0.0f;
+            return;
+        }
+
+        // Forward: instant rise, release-smoothed fall. Only the state at
+        // the end of the window is carried over; the margin is provisional.
+        float y = forwardState;
+        for (int i = 0; i < total; ++i)
+        {
+            auto x = data[i];
+            y = x >= y ? x : y + releaseCoeff * (x - y);
+            data[i] = y;
+
+            if (i == window - 1)
+                forwardState = y;
+        }
+
+        // Backward: the attack ramp now runs ahead of each rising edge
+        float z = data[total - 1];
+        for (int i = total - 1; i >= 0; --i)
+        {
+            auto x = data[i];
+            z = x >= z ? x : z + attackCoeff * (x - z);
+            data[i] = z;
+        }
+    }
+
+    // Returns whether any active region overlaps the range
+    bool fillTarget(juce::int64 start, float* dest, int numSamples) const
+    {
+        juce::FloatVectorOperations::clear(dest, numSamples);
+        auto end = start + numSamples;
+        bool any = false;
+
+        auto it = std::partition_point(active.begin(), active.end(),
+                                       [start](const juce::Range<juce::int64>& r) { return r.getEnd() <= start; });
+
+        for (; it != active.end() && it->getStart() < end; ++it)
+        {
+            auto from = juce::jmax(start, it->getStart());
+            auto to = juce::jmin(end, it->getEnd());
+            juce::FloatVectorOperations::fill(dest + (from - start), 1.0f, (int)(to - from));
+            any = true;
+        }
+
+        return any;
+    }
+
+    std::vector<juce::Range<juce::int64>> active;
+    float attackCoeff, releaseCoeff;
+    int margin = 1;
+    int window = 0;
+    juce::int64 windowStart = 0;
+    bool windowValid = false;
+    float forwardState = 0.0f;
+    std::vector<float> scratch;
+};
+
+//==============================================================================
+NonCausalRenderer::NonCausalRenderer(const OfflineRenderer& r, const NonCausalOptions& o)
+    : renderer(r), options(o)
+{
+}
+
+NonCausalRenderResult NonCausalRenderer::render(const RenderJob& job) const
+{
+    NonCausalRenderResult result;
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    RenderSources sources;
+    if (!renderer.openSources(sources, job, result.error))
+        return result;
+
+    const auto& settings = renderer.getSettings();
+    auto sampleRate = sources.getSampleRate();
+    auto numChannels = sources.getNumChannels();
+    auto length = sources.getLengthInSamples();
+    auto blockSize = renderer.getBlockSize();
+
+    // Pass 1: key analysis
+    TriggerTrack track;
+    auto& key = sources.sidechain != nullptr ? *sources.sidechain : *sources.main;
+    if (!KeyAnalyser(settings).analyse(key, track, result.error))
+        return result;
+
+    result.numRegions = (int)track.regions.size();
+    result.analysisSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    // Widen each region by the pre-roll and hold, merging any that now touch
+    auto preRoll = (juce::int64)std::ceil(options.preRollMs * 0.001 * sampleRate);
+    auto hold = (juce::int64)std::ceil(settings.getHoldMs() * 0.001 * sampleRate);
+
+    std::vector<juce::Range<juce::int64>> active;
+    for (auto& region : track.regions)
+    {
+        juce::Range<juce::int64> widened { region.getStart() - preRoll, region.getEnd() + hold };
+        if (!active.empty() && widened.getStart() <= active.back().getEnd())
+            active.back().setEnd(juce::jmax(active.back().getEnd(), widened.getEnd()));
+        else
+            active.push_back(widened);
+    }
+
+    EnvelopeBuilder envelopeBuilder(std::move(active),
+                                    DSPUtils::calculateCoefficient(sampleRate, settings.attack),
+                                    DSPUtils::calculateCoefficient(sampleRate, settings.getReleaseMs()),
+                                    blockSize);
+
+    // Gain = 1 - depth * shaped envelope, depth folding in duck/range and mix
+    auto duckedGain = juce::jmax(DSPUtils::decibelsToLinear(settings.duckAmount), DSPUtils::decibelsToLinear(settings.range));
+    auto depth = (settings.mix / 100.0f) * (1.0f - duckedGain);
+    auto shape = static_cast<DSPUtils::CurveShape>(settings.curveShape);
+
+    // Pass 2: render
+    {
+        auto output = renderer.createOutput(job.outputFile, sampleRate, numChannels, result.error);
+        if (output == nullptr)
+            return result;
+
+        juce::AudioBuffer<float> mainBuffer(numChannels, blockSize);
+        juce::HeapBlock<float> gain((size_t)blockSize);
+
+        for (juce::int64 pos = 0; pos < length; pos += blockSize)
+        {
+            auto numSamples = (int)juce::jmin((juce::int64)blockSize, length - pos);
+            mainBuffer.setSize(numChannels, numSamples, false, false, true);
+            sources.main->read(&mainBuffer, 0, numSamples, pos, true, numChannels > 1);
+
+            envelopeBuilder.build(pos, gain, numSamples);
+
+            if (shape != DSPUtils::CurveShape::Linear)
+                for (int i = 0; i < numSamples; ++i)
+                    gain[i] = DSPUtils::applyCurveShape(gain[i], shape);
+
+            juce::FloatVectorOperations::multiply(gain, -depth, numSamples);
+            juce::FloatVectorOperations::add(gain, 1.0f, numSamples);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::multiply(mainBuffer.getWritePointer(ch), gain, numSamples);
+
+            output->write(mainBuffer, 0, numSamples);
+        }
+    }
+
+    result.ok = true;
+    result.audioSeconds = (double)length / sampleRate;
+    result.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    return result;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "OfflineRenderer.h"
+
+// Compact result of the whole-file key analysis: the sample ranges where
+// the filtered key exceeds the threshold, at hop resolution.
+struct TriggerTrack
+{
+    double sampleRate = 0.0;
+    juce::int64 lengthInSamples = 0;
+    int hopSize = 32;
+    std::vector<juce::Range<juce::int64>> regions;   // sorted, non-overlapping
+
+    juce::int64 getTriggeredSamples() const;
+};
+
+// First pass: filters the key (sidechain, or main when there is none) with
+// the plugin's sidechain filters and thresholds the per-hop peak. Summing,
+// rectifying and peak-finding run on whole blocks with FloatVectorOperations.
+class KeyAnalyser
+{
+public:
+    explicit KeyAnalyser(const DuckerSettings& settings, int hopSize = 32, int blockSize = 1 << 16);
+
+    bool analyse(juce::AudioFormatReader& key, TriggerTrack& track, juce::String& error) const;
+
+private:
+    DuckerSettings settings;
+    int hopSize;
+    int blockSize;
+};
+
+struct NonCausalOptions
+{
+    double preRollMs = 20.0;       // duck is fully down this long before each onset
+};
+
+struct NonCausalRenderResult : RenderResult
+{
+    double analysisSeconds = 0.0;  // wall time of the key pass
+    int numRegions = 0;
+};
+
+// Two-pass offline ducking. The trigger regions are widened by the pre-roll
+// before and the hold after, then smoothed forward with the release time and
+// backward with the attack time, so each duck ramps down ahead of the onset
+// instead of after it. No look-ahead delay is involved: output is aligned
+// with the input and there is no 20 ms limit on how early a duck can start.
+// Zero-crossing gating and sidechain listen do not apply in this mode.
+class NonCausalRenderer
+{
+public:
+    NonCausalRenderer(const OfflineRenderer& renderer, const NonCausalOptions& options);
+
+    NonCausalRenderResult render(const RenderJob& job) const;
+
+private:
+    // Duck envelope (0..1) for consecutive blocks. It is computed in windows
+    // of at least four attack-convergence margins: the forward state carries
+    // across windows and the backward pass runs one margin past each.
+    class EnvelopeBuilder;
+
+    const OfflineRenderer& renderer;
+    NonCausalOptions options;
+};
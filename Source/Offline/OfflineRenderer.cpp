@@ -0,0 +1,397 @@
+#include "OfflineRenderer.h"
+#include "../Diagnostics/LiveStats.h"
+
+namespace
+{
+    // Reads a memory-mapped WAV/AIFF through a sliding window, remapping as
+    // the read position moves on, so resident memory stays bounded however
+    // long the file is.
+    class MappedWindowReader : public juce::AudioFormatReader
+    {
+    public:
+        MappedWindowReader(juce::MemoryMappedAudioFormatReader* mappedReader, juce::int64 windowSamples)
+            : AudioFormatReader(nullptr, mappedReader->getFormatName()),
+              source(mappedReader),
+              windowSize(juce::jmax((juce::int64)4096, windowSamples))
+        {
+            sampleRate = source->sampleRate;
+            bitsPerSample = source->bitsPerSample;
+            lengthInSamples = source->lengthInSamples;
+            numChannels = source->numChannels;
+            usesFloatingPointData = source->usesFloatingPointData;
+        }
+
+        bool readSamples(int* const* destChannels, int numDestChannels, int startOffsetInDestBuffer,
+                         juce::int64 startSampleInFile, int numSamples) override
+        {
+            clearSamplesBeyondAvailableLength(destChannels, numDestChannels, startOffsetInDestBuffer,
+                                              startSampleInFile, numSamples, lengthInSamples);
+
+            while (numSamples > 0)
+            {
+                if (!mapped.contains(startSampleInFile))
+                {
+                    mapped = { startSampleInFile, juce::jmin(lengthInSamples, startSampleInFile + windowSize) };
+                    if (!source->mapSectionOfFile(mapped))
+                    {
+                        mapped = {};
+                        return false;
+                    }
+                }
+
+                auto n = (int)juce::jmin((juce::int64)numSamples, mapped.getEnd() - startSampleInFile);
+                if (!source->readSamples(destChannels, numDestChannels, startOffsetInDestBuffer, startSampleInFile, n))
+                    return false;
+
+                startOffsetInDestBuffer += n;
+                startSampleInFile += n;
+                numSamples -= n;
+            }
+
+            return true;
+        }
+
+    private:
+        std::unique_ptr<juce::MemoryMappedAudioFormatReader> source;
+        juce::int64 windowSize;
+        juce::Range<juce::int64> mapped;
+    };
+}
+
+//==============================================================================
+std::unique_ptr<juce::AudioFormatReader> RenderSources::createReader(const juce::File& file,
+                                                                     juce::TimeSliceThread* readThread,
+                                                                     const StreamingOptions& streaming)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader;
+
+    if (readThread != nullptr)
+        if (auto* format = formatManager.findFormatForFileExtension(file.getFileExtension()))
+            if (auto* mappedReader = format->createMemoryMappedReader(file))
+                reader = std::make_unique<MappedWindowReader>(mappedReader,
+                                                              (juce::int64)streaming.chunkSamples * streaming.mapWindowChunks);
+
+    if (reader == nullptr)
+        reader.reset(formatManager.createReaderFor(file));
+
+    if (reader == nullptr || readThread == nullptr)
+        return reader;
+
+    // Read ahead on the I/O thread; block rather than return silence if it lags
+    auto buffered = std::make_unique<juce::BufferingAudioReader>(reader.release(), *readThread,
+                                                                 streaming.chunkSamples * streaming.readAheadChunks);
+    buffered->setReadTimeout(-1);
+    return buffered;
+}
+
+bool RenderSources::open(const RenderJob& job, juce::String& error,
+                         juce::TimeSliceThread* readThread, const StreamingOptions& streaming)
+{
+    formatManager.registerBasicFormats();
+
+    main = createReader(job.mainFile, readThread, streaming);
+    if (main == nullptr)
+    {
+        error = "Could not open " + job.mainFile.getFullPathName();
+        return false;
+    }
+
+    if (job.sidechainFile != juce::File())
+    {
+        sidechain = createReader(job.sidechainFile, readThread, streaming);
+        if (sidechain == nullptr)
+        {
+            error = "Could not open " + job.sidechainFile.getFullPathName();
+            return false;
+        }
+
+        if (sidechain->sampleRate != main->sampleRate)
+        {
+            error = "Sample rate mismatch between main and sidechain";
+            return false;
+        }
+    }
+
+    if (main->numChannels < 1)
+    {
+        error = job.mainFile.getFileName() + " has no audio channels";
+        return false;
+    }
+
+    return true;
+}
+
+//==============================================================================
+RenderOutput::RenderOutput(std::unique_ptr<juce::AudioFormatWriter> w, juce::TimeSliceThread* writeThread,
+                           int samplesToBuffer)
+{
+    channelPointers.resize((size_t)w->getNumChannels());
+
+    if (writeThread != nullptr)
+        threadedWriter = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(w.release(), *writeThread,
+                                                                                   samplesToBuffer);
+    else
+        writer = std::move(w);
+}
+
+void RenderOutput::write(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples)
+{
+    if (writer != nullptr)
+    {
+        writer->writeFromAudioSampleBuffer(buffer, startSample, numSamples);
+        return;
+    }
+
+    for (size_t ch = 0; ch < channelPointers.size(); ++ch)
+        channelPointers[ch] = buffer.getReadPointer((int)ch, startSample);
+
+    // Only blocks if the disk has fallen a full buffer behind
+    while (!threadedWriter->write(channelPointers.data(), numSamples))
+        juce::Thread::sleep(1);
+}
+
+//==============================================================================
+OfflineRenderer::OfflineRenderer(const DuckerSettings& s, int block, int bits, const StreamingOptions& streamingOptions)
+    : settings(s), blockSize(juce::jmax(16, block)), bitsPerSample(bits), streaming(streamingOptions)
+{
+    if (streaming.enabled)
+    {
+        for (int i = 0; i < juce::jmax(1, streaming.ioThreads); ++i)
+        {
+            readThreads.add(new juce::TimeSliceThread("Ducker read-ahead " + juce::String(i + 1)))->startThread();
+            writeThreads.add(new juce::TimeSliceThread("Ducker write-behind " + juce::String(i + 1)))->startThread();
+        }
+    }
+}
+
+OfflineRenderer::~OfflineRenderer()
+{
+    for (auto* thread : readThreads)
+        thread->stopThread(2000);
+    for (auto* thread : writeThreads)
+        thread->stopThread(2000);
+}
+
+juce::TimeSliceThread* OfflineRenderer::nextThread(const juce::OwnedArray<juce::TimeSliceThread>& threads,
+                                                   std::atomic<unsigned>& counter) const
+{
+    if (threads.isEmpty())
+        return nullptr;
+
+    return threads[(int)(counter.fetch_add(1, std::memory_order_relaxed) % (unsigned)threads.size())];
+}
+
+bool OfflineRenderer::openSources(RenderSources& sources, const RenderJob& job, juce::String& error) const
+{
+    return sources.open(job, error, nextThread(readThreads, nextReadThread), streaming);
+}
+
+std::unique_ptr<juce::AudioFormatWriter> OfflineRenderer::createWriter(const juce::File& file, double sampleRate,
+                                                                       int numChannels, juce::String& error) const
+{
+    file.deleteFile();
+    auto outStream = std::make_unique<juce::FileOutputStream>(file);
+    if (outStream->failedToOpen())
+    {
+        error = "Could not write " + file.getFullPathName();
+        return {};
+    }
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(outStream.get(), sampleRate,
+                                                                        (unsigned int)numChannels, bitsPerSample,
+                                                                        {}, 0));
+    if (writer == nullptr)
+    {
+        error = "Could not create writer for " + file.getFullPathName();
+        return {};
+    }
+
+    outStream.release(); // owned by the writer now
+    return writer;
+}
+
+std::unique_ptr<RenderOutput> OfflineRenderer::createOutput(const juce::File& file, double sampleRate,
+                                                            int numChannels, juce::String& error) const
+{
+    auto writer = createWriter(file, sampleRate, numChannels, error);
+    if (writer == nullptr)
+        return {};
+
+    auto samplesToBuffer = juce::jmax(streaming.chunkSamples * streaming.writeBehindChunks, 2 * blockSize);
+    return std::make_unique<RenderOutput>(std::move(writer), nextThread(writeThreads, nextWriteThread),
+                                          samplesToBuffer);
+}
+
+void OfflineRenderer::renderRange(RenderSources& sources, RenderOutput& output, Ducker& ducker,
+                                  juce::int64 start, juce::int64 end, juce::int64 preRoll,
+                                  GainTrackWriter* gainTrack) const
+{
+    auto numChannels = sources.getNumChannels();
+
+    // Look-ahead delays the main signal; run that many extra samples and
+    // drop them (plus the pre-roll) from the head of the output
+    preRoll = juce::jmin(preRoll, start);
+    auto latency = (juce::int64)ducker.getLatencyInSamples();
+
+    // Ducker processes the front pair. Any further channels are delayed by
+    // the same latency here (carry in the first `latency` samples of each
+    // delay channel) and multiplied by the gain it applied.
+    auto extraChannels = juce::jmax(0, numChannels - 2);
+    juce::AudioBuffer<float> extraDelay(extraChannels, (int)latency + blockSize);
+    extraDelay.clear();
+
+    juce::AudioBuffer<float> mainBuffer(numChannels, blockSize);
+    juce::AudioBuffer<float> scBuffer(2, blockSize);
+    juce::HeapBlock<float> gains;
+    if (gainTrack != nullptr || extraChannels > 0)
+        gains.malloc((size_t)blockSize);
+
+    // Counters for ducker_stats when DUCKER_STATS=1, one slot per range
+    LiveStats::Publisher liveStats;
+
+    juce::int64 readPos = start - preRoll;
+    juce::int64 toSkip = preRoll + latency;
+    juce::int64 written = 0;
+    auto total = end - start;
+
+    while (written < total)
+    {
+        auto numSamples = (int)juce::jmin((juce::int64)blockSize, end + latency - readPos);
+        mainBuffer.setSize(numChannels, numSamples, false, false, true);
+        scBuffer.setSize(2, numSamples, false, false, true);
+
+        // Reads past the end are zero-filled by the reader
+        sources.main->read(&mainBuffer, 0, numSamples, readPos, true, numChannels > 1);
+
+        if (sources.sidechain != nullptr)
+            sources.sidechain->read(&scBuffer, 0, numSamples, readPos, true, true);
+        else
+            for (int ch = 0; ch < 2; ++ch)
+                scBuffer.copyFrom(ch, 0, mainBuffer, juce::jmin(ch, numChannels - 1), 0, numSamples);
+
+        liveStats.beginBlock();
+
+        juce::AudioBuffer<float> front(mainBuffer.getArrayOfWritePointers(), juce::jmin(2, numChannels), numSamples);
+        ducker.process(front, scBuffer, gains.get());
+
+        for (int e = 0; e < extraChannels; ++e)
+        {
+            auto* delay = extraDelay.getWritePointer(e);
+            auto* channel = mainBuffer.getWritePointer(2 + e);
+
+            juce::FloatVectorOperations::copy(delay + latency, channel, numSamples);
+            juce::FloatVectorOperations::multiply(channel, delay, gains, numSamples);
+            std::memmove(delay, delay + numSamples, sizeof(float) * (size_t)latency);
+        }
+
+        const auto& counters = ducker.getCounters();
+        liveStats.endBlock(numSamples, sources.getSampleRate(), counters.triggers, counters.duckedSamples);
+
+        readPos += numSamples;
+
+        auto skip = (int)juce::jmin((juce::int64)numSamples, toSkip);
+        toSkip -= skip;
+
+        auto numToWrite = (int)juce::jmin((juce::int64)(numSamples - skip), total - written);
+        if (numToWrite > 0)
+        {
+            output.write(mainBuffer, skip, numToWrite);
+            written += numToWrite;
+
+            if (gainTrack != nullptr)
+                gainTrack->write(gains + skip, numToWrite);
+        }
+    }
+}
+
+RenderResult OfflineRenderer::render(const RenderJob& job) const
+{
+    RenderResult result;
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    // Each job opens its own readers so jobs can run in parallel
+    RenderSources sources;
+    if (!openSources(sources, job, result.error))
+        return result;
+
+    {
+        auto output = createOutput(job.outputFile, sources.getSampleRate(), sources.getNumChannels(), result.error);
+        if (output == nullptr)
+            return result;
+
+        if (job.replayGainTrack != juce::File())
+        {
+            if (!replay(sources, job, *output, result.error))
+                return result;
+        }
+        else
+        {
+            GainTrackWriter gainTrack;
+            bool exporting = job.exportGainTrack != juce::File();
+
+            // A track is one gain per sample for all channels. Zero-crossing
+            // gating updates each channel's gain at its own crossings, and
+            // listen outputs the key, so neither can be replayed from it.
+            if (exporting && (settings.zeroCrossing || settings.scListen))
+            {
+                result.error = "Gain tracks cannot be exported with zero-crossing or sidechain listen on";
+                return result;
+            }
+
+            if (exporting && !gainTrack.open(job.exportGainTrack, sources.getSampleRate(), result.error))
+                return result;
+
+            Ducker ducker;
+            settings.applyTo(ducker);
+            ducker.prepare(sources.getSampleRate(), blockSize);
+
+            renderRange(sources, *output, ducker, 0, sources.getLengthInSamples(), 0,
+                        exporting ? &gainTrack : nullptr);
+
+            if (exporting && !gainTrack.finish())
+            {
+                result.error = "Could not write " + job.exportGainTrack.getFullPathName();
+                return result;
+            }
+        }
+    } // output flushed and closed here
+
+    result.ok = true;
+    result.audioSeconds = (double)sources.getLengthInSamples() / sources.getSampleRate();
+    result.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    return result;
+}
+
+bool OfflineRenderer::replay(RenderSources& sources, const RenderJob& job, RenderOutput& output,
+                             juce::String& error) const
+{
+    GainTrackReader gainTrack;
+    if (!gainTrack.open(job.replayGainTrack, error))
+        return false;
+
+    if (gainTrack.getSampleRate() != sources.getSampleRate())
+    {
+        error = "Gain track sample rate does not match " + job.mainFile.getFileName();
+        return false;
+    }
+
+    // Samples past the end of a shorter track are left at unity
+    auto numChannels = sources.getNumChannels();
+    auto length = sources.getLengthInSamples();
+    juce::AudioBuffer<float> mainBuffer(numChannels, blockSize);
+    juce::HeapBlock<float> gains((size_t)blockSize);
+
+    for (juce::int64 pos = 0; pos < length; pos += blockSize)
+    {
+        auto numSamples = (int)juce::jmin((juce::int64)blockSize, length - pos);
+        mainBuffer.setSize(numChannels, numSamples, false, false, true);
+        sources.main->read(&mainBuffer, 0, numSamples, pos, true, numChannels > 1);
+
+        gainTrack.read(gains, numSamples);
+        Ducker::applyGainCurve(mainBuffer, gains, 0, numSamples);
+        output.write(mainBuffer, 0, numSamples);
+    }
+
+    return true;
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <atomic>
+#include "DuckerSettings.h"
+#include "GainTrack.h"
+
+// One main/sidechain file pair to render. If sidechainFile is not set the
+// main signal keys itself, like the plugin with no sidechain connected.
+struct RenderJob
+{
+    juce::File mainFile;
+    juce::File sidechainFile;
+    juce::File outputFile;
+
+    juce::File exportGainTrack;   // if set, the applied gain track is written here
+                                  // (not with zeroCrossing or scListen, see render())
+    juce::File replayGainTrack;   // if set, this track is applied instead of detecting
+};
+
+struct RenderResult
+{
+    bool ok = false;
+    juce::String error;
+    double audioSeconds = 0.0;
+    double wallSeconds = 0.0;
+
+    double getRealtimeFactor() const { return wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0; }
+};
+
+// Bounded-memory file I/O. Inputs are read through a sliding memory-mapped
+// window where the format allows (WAV/AIFF) and buffered ahead on a reader
+// thread; output is written behind on a writer thread. Peak memory is a few
+// chunks per file, independent of file length.
+struct StreamingOptions
+{
+    bool enabled = true;
+    int ioThreads = 1;              // read-ahead and write-behind threads each,
+                                    // handed out to jobs round-robin
+    int chunkSamples = 1 << 16;
+    int readAheadChunks = 4;
+    int writeBehindChunks = 4;
+    int mapWindowChunks = 16;
+};
+
+// Opened, validated readers for a RenderJob
+struct RenderSources
+{
+    juce::AudioFormatManager formatManager;
+    std::unique_ptr<juce::AudioFormatReader> main;
+    std::unique_ptr<juce::AudioFormatReader> sidechain;   // null: main keys itself
+
+    // With a read thread, readers are memory-mapped where possible and
+    // buffered ahead on that thread
+    bool open(const RenderJob& job, juce::String& error,
+              juce::TimeSliceThread* readThread = nullptr, const StreamingOptions& streaming = {});
+
+    int getNumChannels() const { return (int)main->numChannels; }
+    double getSampleRate() const { return main->sampleRate; }
+    juce::int64 getLengthInSamples() const { return main->lengthInSamples; }
+
+private:
+    std::unique_ptr<juce::AudioFormatReader> createReader(const juce::File& file, juce::TimeSliceThread* readThread,
+                                                          const StreamingOptions& streaming);
+};
+
+// Destination for rendered audio: either a plain writer, or one that hands
+// blocks to a background thread (write-behind) so DSP never waits on disk.
+class RenderOutput
+{
+public:
+    RenderOutput(std::unique_ptr<juce::AudioFormatWriter> writer, juce::TimeSliceThread* writeThread, int samplesToBuffer);
+
+    void write(const juce::AudioBuffer<float>& buffer, int startSample, int numSamples);
+
+private:
+    std::unique_ptr<juce::AudioFormatWriter> writer;
+    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> threadedWriter;
+    std::vector<const float*> channelPointers;
+};
+
+// Renders a file pair through Ducker block by block (GUI-free). Output is
+// latency-compensated so it lines up sample-for-sample with the input.
+// Mains with more than two channels (surround beds) are ducked on all of
+// them with the gain detected for the front pair.
+class OfflineRenderer
+{
+public:
+    OfflineRenderer(const DuckerSettings& settings, int blockSize = 4096, int bitsPerSample = 24,
+                    const StreamingOptions& streaming = {});
+    ~OfflineRenderer();
+
+    RenderResult render(const RenderJob& job) const;
+
+    // Building blocks shared by the other offline modes ---------------------
+
+    bool openSources(RenderSources& sources, const RenderJob& job, juce::String& error) const;
+
+    // Plain writer (no write-behind)
+    std::unique_ptr<juce::AudioFormatWriter> createWriter(const juce::File& file, double sampleRate,
+                                                          int numChannels, juce::String& error) const;
+
+    // Writer with write-behind when streaming is enabled
+    std::unique_ptr<RenderOutput> createOutput(const juce::File& file, double sampleRate,
+                                               int numChannels, juce::String& error) const;
+
+    // Renders output samples [start, end) into the output. The DSP is first
+    // run over [start - preRoll, start) with its output discarded, so filter,
+    // envelope and delay-line state can converge before the range begins.
+    // If gainTrack is given, the gains applied to the range are appended to it.
+    void renderRange(RenderSources& sources, RenderOutput& output, Ducker& ducker,
+                     juce::int64 start, juce::int64 end, juce::int64 preRoll,
+                     GainTrackWriter* gainTrack = nullptr) const;
+
+    const DuckerSettings& getSettings() const { return settings; }
+    int getBlockSize() const { return blockSize; }
+
+private:
+    // Applies job.replayGainTrack to the main file; the sidechain is not read
+    bool replay(RenderSources& sources, const RenderJob& job, RenderOutput& output, juce::String& error) const;
+
+    DuckerSettings settings;
+    int blockSize;
+    int bitsPerSample;
+    StreamingOptions streaming;
+
+    juce::TimeSliceThread* nextThread(const juce::OwnedArray<juce::TimeSliceThread>& threads,
+                                      std::atomic<unsigned>& counter) const;
+
+    // I/O threads, shared round-robin by the jobs rendered through this
+    // renderer (size them with the worker pool so jobs don't queue on disk)
+    juce::OwnedArray<juce::TimeSliceThread> readThreads, writeThreads;
+    mutable std::atomic<unsigned> nextReadThread { 0 }, nextWriteThread { 0 };
+};
@@ -0,0 +1,241 @@
+#include "PcmPipe.h"
+#include "../Diagnostics/LiveStats.h"
+
+namespace
+{
+    template <typename Decode>
+    void deinterleave(const char* src, float* const* dest, int numChannels, int numFrames,
+                      int bytesPerSample, Decode decode)
+    {
+        for (int i = 0; i < numFrames; ++i)
+            for (int ch = 0; ch < numChannels; ++ch, src += bytesPerSample)
+                dest[ch][i] = decode(src);
+    }
+
+    template <typename Encode>
+    void interleave(const float* const* src, int startSample, char* dest, int numChannels, int numFrames,
+                    int bytesPerSample, Encode encode)
+    {
+        for (int i = startSample; i < startSample + numFrames; ++i)
+            for (int ch = 0; ch < numChannels; ++ch, dest += bytesPerSample)
+                encode(src[ch][i], dest);
+    }
+
+    float decodeS16(const char* p)
+    {
+        return (float)(juce::int16)juce::ByteOrder::littleEndianShort(p) * (1.0f / 32768.0f);
+    }
+
+    float decodeS24(const char* p)
+    {
+        return (float)juce::ByteOrder::littleEndian24Bit(p) * (1.0f / 8388608.0f);
+    }
+
+    float decodeF32(const char* p)
+    {
+        auto bits = juce::ByteOrder::littleEndianInt(p);
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    void encodeS16(float x, char* p)
+    {
+        auto value = (juce::uint16)(juce::int16)juce::jlimit(-32768, 32767, juce::roundToInt(x * 32768.0f));
+        value = juce::ByteOrder::swapIfBigEndian(value);
+        std::memcpy(p, &value, sizeof(value));
+    }
+
+    void encodeS24(float x, char* p)
+    {
+        juce::ByteOrder::littleEndian24BitToChars(juce::jlimit(-8388608, 8388607, juce::roundToInt(x * 8388608.0f)), p);
+    }
+
+    void encodeF32(float x, char* p)
+    {
+        juce::uint32 bits;
+        std::memcpy(&bits, &x, sizeof(bits));
+        bits = juce::ByteOrder::swapIfBigEndian(bits);
+        std::memcpy(p, &bits, sizeof(bits));
+    }
+}
+
+//==============================================================================
+int PcmFormat::getBytesPerSample() const
+{
+    switch (encoding)
+    {
+        case Encoding::s16: return 2;
+        case Encoding::s24: return 3;
+        case Encoding::f32: return 4;
+    }
+
+    return 4;
+}
+
+bool PcmFormat::parseEncoding(const juce::String& text, Encoding& result)
+{
+    auto name = text.trim().toLowerCase();
+    if (name.endsWith("le"))
+        name = name.dropLastCharacters(2);
+
+    if (name == "s16")      result = Encoding::s16;
+    else if (name == "s24") result = Encoding::s24;
+    else if (name == "f32") result = Encoding::f32;
+    else                    return false;
+
+    return true;
+}
+
+//==============================================================================
+PcmInput::PcmInput(std::FILE* f, const PcmFormat& fmt, int maxFrames)
+    : file(f), format(fmt), bytes((size_t)(fmt.getBytesPerFrame() * maxFrames))
+{
+}
+
+int PcmInput::read(juce::AudioBuffer<float>& dest, int numFrames)
+{
+    // fread only returns whole frames; a trailing partial frame is dropped
+    auto frames = (int)std::fread(bytes.get(), (size_t)format.getBytesPerFrame(), (size_t)numFrames, file);
+    auto* const* channels = dest.getArrayOfWritePointers();
+    auto bps = format.getBytesPerSample();
+
+    switch (format.encoding)
+    {
+        case PcmFormat::Encoding::s16: deinterleave(bytes.get(), channels, format.numChannels, frames, bps, decodeS16); break;
+        case PcmFormat::Encoding::s24: deinterleave(bytes.get(), channels, format.numChannels, frames, bps, decodeS24); break;
+        case PcmFormat::Encoding::f32: deinterleave(bytes.get(), channels, format.numChannels, frames, bps, decodeF32); break;
+    }
+
+    return frames;
+}
+
+//==============================================================================
+PcmOutput::PcmOutput(std::FILE* f, const PcmFormat& fmt, int maxFrames)
+    : file(f), format(fmt), bytes((size_t)(fmt.getBytesPerFrame() * maxFrames))
+{
+}
+
+bool PcmOutput::write(const juce::AudioBuffer<float>& source, int startSample, int numFrames)
+{
+    auto* const* channels = source.getArrayOfReadPointers();
+    auto bps = format.getBytesPerSample();
+
+    switch (format.encoding)
+    {
+        case PcmFormat::Encoding::s16: interleave(channels, startSample, bytes.get(), format.numChannels, numFrames, bps, encodeS16); break;
+        case PcmFormat::Encoding::s24: interleave(channels, startSample, bytes.get(), format.numChannels, numFrames, bps, encodeS24); break;
+        case PcmFormat::Encoding::f32: interleave(channels, startSample, bytes.get(), format.numChannels, numFrames, bps, encodeF32); break;
+    }
+
+    auto frameBytes = (size_t)format.getBytesPerFrame();
+    return std::fwrite(bytes.get(), frameBytes, (size_t)numFrames, file) == (size_t)numFrames
+        && std::fflush(file) == 0;
+}
+
+//==============================================================================
+PipeRenderer::PipeRenderer(const DuckerSettings& s, const PipeOptions& o)
+    : settings(s), options(o)
+{
+    options.blockSize = juce::jmax(16, options.blockSize);
+    options.output.numChannels = options.main.numChannels;
+}
+
+bool PipeRenderer::run(std::FILE* mainIn, std::FILE* sidechainIn, std::FILE* out, juce::String& error)
+{
+    const auto blockSize = options.blockSize;
+    const auto numChannels = options.main.numChannels;
+
+    if (numChannels < 1 || numChannels > 2 || options.sidechain.numChannels < 1 || options.sidechain.numChannels > 2)
+    {
+        error = "Only mono or stereo streams are supported";
+        return false;
+    }
+
+    PcmInput mainInput(mainIn, options.main, blockSize);
+    std::unique_ptr<PcmInput> sidechainInput;
+    if (sidechainIn != nullptr)
+        sidechainInput = std::make_unique<PcmInput>(sidechainIn, options.sidechain, blockSize);
+
+    PcmOutput output(out, options.output, blockSize);
+
+    Ducker ducker;
+    settings.applyTo(ducker);
+    ducker.prepare(options.sampleRate, blockSize);
+
+    juce::AudioBuffer<float> mainBuffer(numChannels, blockSize);
+    juce::AudioBuffer<float> scBuffer(2, blockSize);
+
+    // Counters for ducker_stats when DUCKER_STATS=1
+    LiveStats::Publisher liveStats;
+
+    // Drop the look-ahead delay from the head, then flush it with silence
+    // once the input ends
+    auto latency = (juce::int64)ducker.getLatencyInSamples();
+    auto toSkip = latency;
+    auto tailRemaining = latency;
+    bool mainEnded = false;
+    framesWritten = 0;
+
+    for (;;)
+    {
+        mainBuffer.setSize(numChannels, blockSize, false, false, true);
+        scBuffer.setSize(2, blockSize, false, false, true);
+
+        int numSamples = 0;
+        if (!mainEnded)
+        {
+            numSamples = mainInput.read(mainBuffer, blockSize);
+            mainEnded = numSamples < blockSize;
+        }
+
+        if (mainEnded)
+        {
+            auto pad = (int)juce::jmin((juce::int64)(blockSize - numSamples), tailRemaining);
+            mainBuffer.clear(numSamples, pad);
+            numSamples += pad;
+            tailRemaining -= pad;
+        }
+
+        if (numSamples == 0)
+            break;
+
+        if (sidechainInput != nullptr)
+        {
+            // A sidechain that ends early keys silence from then on
+            auto got = sidechainInput->read(scBuffer, numSamples);
+            if (options.sidechain.numChannels == 1)
+                scBuffer.copyFrom(1, 0, scBuffer, 0, 0, got);
+            scBuffer.clear(got, numSamples - got);
+        }
+        else
+        {
+            for (int ch = 0; ch < 2; ++ch)
+                scBuffer.copyFrom(ch, 0, mainBuffer, juce::jmin(ch, numChannels - 1), 0, numSamples);
+        }
+
+        mainBuffer.setSize(numChannels, numSamples, true, false, true);
+        scBuffer.setSize(2, numSamples, true, false, true);
+        liveStats.beginBlock();
+        ducker.process(mainBuffer, scBuffer);
+
+        const auto& counters = ducker.getCounters();
+        liveStats.endBlock(numSamples, options.sampleRate, counters.triggers, counters.duckedSamples);
+
+        auto skip = (int)juce::jmin((juce::int64)numSamples, toSkip);
+        toSkip -= skip;
+
+        if (numSamples > skip)
+        {
+            if (!output.write(mainBuffer, skip, numSamples - skip))
+            {
+                error = "Write to output failed (closed pipe?)";
+                return false;
+            }
+
+            framesWritten += numSamples - skip;
+        }
+    }
+
+    return true;
+}
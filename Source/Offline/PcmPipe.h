@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstdio>
+#include "DuckerSettings.h"
+
+// Raw interleaved little-endian PCM layout, as produced by ffmpeg's
+// -f s16le / s24le / f32le.
+struct PcmFormat
+{
+    enum class Encoding { s16, s24, f32 };
+
+    Encoding encoding = Encoding::f32;
+    int numChannels = 2;
+
+    int getBytesPerSample() const;
+    int getBytesPerFrame() const { return getBytesPerSample() * numChannels; }
+
+    // "s16", "s24", "f32" (an optional "le" suffix is accepted)
+    static bool parseEncoding(const juce::String& text, Encoding& encoding);
+};
+
+// Reads PCM frames from a stream, converting and deinterleaving in one pass
+// straight into the channels of an AudioBuffer.
+class PcmInput
+{
+public:
+    PcmInput(std::FILE* file, const PcmFormat& format, int maxFrames);
+
+    // Fills dest channels [0, numChannels) from sample 0. Returns the number
+    // of frames read, less than numFrames only at the end of the stream.
+    int read(juce::AudioBuffer<float>& dest, int numFrames);
+
+private:
+    std::FILE* file;
+    PcmFormat format;
+    juce::HeapBlock<char> bytes;
+};
+
+// Interleaves and converts in one pass, then writes and flushes
+class PcmOutput
+{
+public:
+    PcmOutput(std::FILE* file, const PcmFormat& format, int maxFrames);
+
+    bool write(const juce::AudioBuffer<float>& source, int startSample, int numFrames);
+
+private:
+    std::FILE* file;
+    PcmFormat format;
+    juce::HeapBlock<char> bytes;
+};
+
+struct PipeOptions
+{
+    double sampleRate = 48000.0;
+    int blockSize = 256;           // small: bounds the added latency
+    PcmFormat main;
+    PcmFormat sidechain;
+    PcmFormat output;              // channel count follows main
+};
+
+// Streams main (and optionally sidechain) PCM through Ducker until the main
+// input ends. Output is latency-compensated: the look-ahead delay is dropped
+// from the head and flushed at the end, so it has as many frames as the input.
+class PipeRenderer
+{
+public:
+    PipeRenderer(const DuckerSettings& settings, const PipeOptions& options);
+
+    // sidechainIn may be null, in which case the main signal keys itself
+    bool run(std::FILE* mainIn, std::FILE* sidechainIn, std::FILE* out, juce::String& error);
+
+    juce::int64 getFramesWritten() const { return framesWritten; }
+
+private:
+    DuckerSettings settings;
+    PipeOptions options;
+    juce::int64 framesWritten = 0;
+};
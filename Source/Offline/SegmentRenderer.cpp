@@ -0,0 +1,189 @@
+#include "SegmentRenderer.h"
+
+SegmentRenderer::SegmentRenderer(const OfflineRenderer& r)
+    : renderer(r)
+{
+}
+
+juce::int64 SegmentRenderer::getConvergenceSamples(const DuckerSettings& settings, double sampleRate)
+{
+    // One-pole attack/release take ln(1000) time constants to cross the
+    // 0.999 / 0.001 state thresholds; hold is a fixed counter. Allow 50 ms
+    // for the sidechain biquads to settle and add the look-ahead delay.
+    const double timeConstants = std::log(1000.0);
+    auto ms = timeConstants * (settings.attack + settings.getReleaseMs())
+            + settings.getHoldMs() + settings.lookAhead + 50.0;
+
+    return (juce::int64)std::ceil(ms * 0.001 * sampleRate);
+}
+
+SegmentRenderResult SegmentRenderer::render(const RenderJob& job, const SegmentRenderOptions& options,
+                                            juce::ThreadPool& pool) const
+{
+    SegmentRenderResult result;
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    RenderSources probe;
+    if (!renderer.openSources(probe, job, result.error))
+        return result;
+
+    auto sampleRate = probe.getSampleRate();
+    auto numChannels = probe.getNumChannels();
+    auto length = probe.getLengthInSamples();
+    const auto& settings = renderer.getSettings();
+
+    result.overlapSamples = options.overlapSeconds > 0.0
+                          ? (juce::int64)(options.overlapSeconds * sampleRate)
+                          : 2 * getConvergenceSamples(settings, sampleRate);
+
+    // Segments shorter than a few overlaps spend most of their time warming up
+    auto numSegments = options.numSegments > 0 ? options.numSegments : pool.getNumThreads();
+    auto maxSegments = juce::jmax((juce::int64)1, length / juce::jmax((juce::int64)1, 4 * result.overlapSamples));
+    numSegments = (int)juce::jlimit((juce::int64)1, maxSegments, (juce::int64)numSegments);
+    result.numSegments = numSegments;
+
+    // Each segment renders into its own temporary file, concatenated in order
+    juce::Array<juce::File> segmentFiles;
+    for (int s = 0; s < numSegments; ++s)
+        segmentFiles.add(job.outputFile.getSiblingFile(job.outputFile.getFileNameWithoutExtension()
+                                                       + ".seg" + juce::String(s) + ".wav"));
+
+    juce::StringArray errors;
+    juce::CriticalSection errorLock;
+    std::atomic<int> remaining { numSegments };
+    juce::WaitableEvent allDone;
+
+    for (int s = 0; s < numSegments; ++s)
+    {
+        pool.addJob([&, s]
+        {
+            auto segStart = length * s / numSegments;
+            auto segEnd = length * (s + 1) / numSegments;
+
+            juce::String error;
+            RenderSources sources;
+            if (renderer.openSources(sources, job, error))
+            {
+                if (auto output = renderer.createOutput(segmentFiles[s], sampleRate, numChannels, error))
+                {
+                    Ducker ducker;
+                    settings.applyTo(ducker);
+                    ducker.prepare(sampleRate, renderer.getBlockSize());
+                    renderer.renderRange(sources, *output, ducker, segStart, segEnd, result.overlapSamples);
+                }
+            }
+
+            if (error.isNotEmpty())
+            {
+                const juce::ScopedLock sl(errorLock);
+                errors.add(error);
+            }
+
+            if (--remaining == 0)
+                allDone.signal();
+        });
+    }
+
+    allDone.wait();
+
+    if (errors.isEmpty())
+    {
+        // Concatenate the segments into the final file
+        if (auto writer = renderer.createWriter(job.outputFile, sampleRate, numChannels, result.error))
+        {
+            juce::AudioFormatManager formatManager;
+            formatManager.registerBasicFormats();
+
+            for (auto& file : segmentFiles)
+            {
+                std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+                if (reader == nullptr || !writer->writeFromAudioReader(*reader, 0, reader->lengthInSamples))
+                {
+                    result.error = "Could not append segment " + file.getFileName();
+                    break;
+                }
+            }
+        }
+    }
+    else
+    {
+        result.error = errors.joinIntoString("; ");
+    }
+
+    for (auto& file : segmentFiles)
+        file.deleteFile();
+
+    if (result.error.isNotEmpty())
+        return result;
+
+    result.audioSeconds = (double)length / sampleRate;
+    result.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    result.ok = true;
+
+    if (options.verify)
+    {
+        // Sequential reference render, then compare
+        auto reference = job;
+        reference.outputFile = job.outputFile.getSiblingFile(job.outputFile.getFileNameWithoutExtension() + ".sequential.wav");
+
+        auto sequential = renderer.render(reference);
+        if (!sequential.ok)
+        {
+            result.ok = false;
+            result.error = "Verification render failed: " + sequential.error;
+            return result;
+        }
+
+        result.maxDeviation = compareFiles(job.outputFile, reference.outputFile, result.error);
+        reference.outputFile.deleteFile();
+
+        if (result.error.isNotEmpty() || result.maxDeviation > options.tolerance)
+        {
+            result.ok = false;
+            if (result.error.isEmpty())
+                result.error = juce::String::formatted("Deviation %.3g exceeds tolerance %.3g",
+                                                       (double)result.maxDeviation, (double)options.tolerance);
+        }
+    }
+
+    return result;
+}
+
+float SegmentRenderer::compareFiles(const juce::File& a, const juce::File& b, juce::String& error)
+{
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> readerA(formatManager.createReaderFor(a));
+    std::unique_ptr<juce::AudioFormatReader> readerB(formatManager.createReaderFor(b));
+
+    if (readerA == nullptr || readerB == nullptr
+        || readerA->numChannels != readerB->numChannels
+        || readerA->lengthInSamples != readerB->lengthInSamples)
+    {
+        error = "Files differ in layout or could not be read";
+        return -1.0f;
+    }
+
+    const int blockSize = 65536;
+    auto numChannels = (int)readerA->numChannels;
+    juce::AudioBuffer<float> bufA(numChannels, blockSize), bufB(numChannels, blockSize);
+    float maxDiff = 0.0f;
+
+    for (juce::int64 pos = 0; pos < readerA->lengthInSamples; pos += blockSize)
+    {
+        auto n = (int)juce::jmin((juce::int64)blockSize, readerA->lengthInSamples - pos);
+        readerA->read(&bufA, 0, n, pos, true, true);
+        readerB->read(&bufB, 0, n, pos, true, true);
+
+        for (int ch = 0; ch < numChannels; ++ch)
+        {
+            auto* pa = bufA.getReadPointer(ch);
+            auto* pb = bufB.getReadPointer(ch);
+            for (int i = 0; i < n; ++i)
+                maxDiff = juce::jmax(maxDiff, std::abs(pa[i] - pb[i]));
+        }
+    }
+
+    return maxDiff;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "OfflineRenderer.h"
+
+// Renders one long file as N segments in parallel.
+//
+// Ducker's envelope is sequential, so each segment is warmed up by running
+// the full DSP (sidechain filters, envelope, look-ahead delay, zero-crossing
+// state) over an overlap region before the segment starts. Envelope state
+// differences contract geometrically through the attack/release one-poles,
+// so with the default overlap (twice the convergence estimate) the output
+// matches a sequential render to well below the default tolerance of 1e-4.
+// Use verify to measure the actual deviation against a sequential render.
+struct SegmentRenderOptions
+{
+    int numSegments = 0;          // 0: one per core
+    double overlapSeconds = 0.0;  // 0: 2x the convergence estimate
+    bool verify = false;
+    float tolerance = 1.0e-4f;
+};
+
+struct SegmentRenderResult : RenderResult
+{
+    int numSegments = 0;
+    juce::int64 overlapSamples = 0;
+    float maxDeviation = -1.0f;   // only set when verifying
+};
+
+class SegmentRenderer
+{
+public:
+    explicit SegmentRenderer(const OfflineRenderer& renderer);
+
+    // Samples for the filter and envelope to forget their initial state
+    static juce::int64 getConvergenceSamples(const DuckerSettings& settings, double sampleRate);
+
+    SegmentRenderResult render(const RenderJob& job, const SegmentRenderOptions& options,
+                               juce::ThreadPool& pool) const;
+
+    // Largest absolute sample difference between two files of equal layout
+    static float compareFiles(const juce::File& a, const juce::File& b, juce::String& error);
+
+private:
+    const OfflineRenderer& renderer;
+};
@@ -0,0 +1,401 @@
+#include "SweepRenderer.h"
+
+namespace
+{
+    // Envelope followers for many variants, stored as structure-of-arrays.
+    // Each lane follows EnvelopeGenerator's state machine exactly and emits
+    // the final applied gain (duck depth, range floor and mix folded in).
+    class EnvelopeLanes
+    {
+    public:
+        enum State : int { idle, attack, hold, release };
+
+        void addLane(const DuckerSettings& s, double sampleRate)
+        {
+            auto duckedGain = juce::jmax(DSPUtils::decibelsToLinear(s.duckAmount), DSPUtils::decibelsToLinear(s.range));
+
+            threshold.push_back(DSPUtils::decibelsToLinear(s.threshold));
+            attackCoeff.push_back(DSPUtils::calculateCoefficient(sampleRate, s.attack));
+            releaseCoeff.push_back(DSPUtils::calculateCoefficient(sampleRate, s.getReleaseMs()));
+            holdSamples.push_back(static_cast<int>(s.getHoldMs() * 0.001f * sampleRate));
+            depth.push_back((s.mix / 100.0f) * (1.0f - duckedGain));
+            shape.push_back(static_cast<DSPUtils::CurveShape>(s.curveShape));
+
+            envelope.push_back(0.0f);
+            holdCounter.push_back(0);
+            state.push_back(idle);
+        }
+
+        int getNumLanes() const { return (int)threshold.size(); }
+
+        // keyAbs: rectified filtered key. gains[lane] receives numSamples gains.
+        void process(const float* keyAbs, int numSamples, float* const* gains)
+        {
+            const int numLanes = getNumLanes();
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const float x = keyAbs[i];
+
+                for (int l = 0; l < numLanes; ++l)
+                {
+                    const bool trigger = x > threshold[(size_t)l];
+                    auto& st = state[(size_t)l];
+                    auto& env = envelope[(size_t)l];
+                    auto& counter = holdCounter[(size_t)l];
+
+                    if (trigger)
+                    {
+                        counter = holdSamples[(size_t)l];
+                        if (st == idle || st == release)
+                            st = attack;
+                    }
+
+                    switch (st)
+                    {
+                        case idle:
+                            env = 0.0f;
+                            break;
+
+                        case attack:
+                            env += attackCoeff[(size_t)l] * (1.0f - env);
+                            if (env >= 0.999f)
+                            {
+                                env = 1.0f;
+                                st = hold;
+                            }
+                            break;
+
+                        case hold:
+                            env = 1.0f;
+                            if (--counter <= 0 && !trigger)
+                                st = release;
+                            break;
+
+                        case release:
+                            env -= releaseCoeff[(size_t)l] * env;
+                            if (env < 0.001f)
+                            {
+                                env = 0.0f;
+                                st = idle;
+                            }
+                            break;
+                    }
+
+                    gains[l][i] = 1.0f - depth[(size_t)l] * DSPUtils::applyCurveShape(env, shape[(size_t)l]);
+                }
+            }
+        }
+
+    private:
+        std::vector<float> threshold, attackCoeff, releaseCoeff, depth, envelope;
+        std::vector<int> holdSamples, holdCounter, state;
+        std::vector<DSPUtils::CurveShape> shape;
+    };
+
+    struct FilterKey
+    {
+        bool hpf, lpf;
+        float hpfFreq, lpfFreq;
+
+        static FilterKey from(const DuckerSettings& s)
+        {
+            return { s.scHPFEnabled, s.scLPFEnabled, s.scHPFEnabled ? s.scHPFFreq : 0.0f,
+                     s.scLPFEnabled ? s.scLPFFreq : 0.0f };
+        }
+
+        bool operator==(const FilterKey& o) const
+        {
+            return hpf == o.hpf && lpf == o.lpf && hpfFreq == o.hpfFreq && lpfFreq == o.lpfFreq;
+        }
+    };
+
+    // Variants sharing one filtered key
+    struct FilterGroup
+    {
+        FilterKey key;
+        SidechainProcessor filter;
+        EnvelopeLanes lanes;
+        std::vector<int> variantIndices;
+        std::vector<float*> gainPointers;
+    };
+
+    struct StatsAccumulator
+    {
+        double sumDb = 0.0;
+        double maxDb = 0.0;
+        juce::int64 ducked = 0;
+        juce::int64 count = 0;
+
+        void add(const float* gains, int numSamples)
+        {
+            constexpr float oneDb = 0.891251f;
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                auto g = gains[i];
+                if (g >= 1.0f)
+                    continue;
+
+                auto db = -(double)DSPUtils::linearToDecibels(g);
+                sumDb += db;
+                maxDb = juce::jmax(maxDb, db);
+                ducked += g < oneDb ? 1 : 0;
+            }
+
+            count += numSamples;
+        }
+
+        SweepStats get() const
+        {
+            SweepStats s;
+            s.meanGainReductionDb = count > 0 ? sumDb / (double)count : 0.0;
+            s.maxGainReductionDb = maxDb;
+            s.duckedFraction = count > 0 ? (double)ducked / (double)count : 0.0;
+            return s;
+        }
+    };
+}
+
+//==============================================================================
+SweepRenderer::SweepRenderer(const OfflineRenderer& r, std::vector<SweepVariant> v)
+    : renderer(r), variants(std::move(v))
+{
+}
+
+bool SweepRenderer::expandGrid(const DuckerSettings& base, const juce::StringArray& axes,
+                               std::vector<SweepVariant>& result, juce::String& error)
+{
+    result.clear();
+
+    if (!checkSupported(base, error))
+        return false;
+
+    result.push_back({ base, {} });
+
+    for (auto& axis : axes)
+    {
+        auto id = axis.upToFirstOccurrenceOf("=", false, false).trim();
+        auto values = juce::StringArray::fromTokens(axis.fromFirstOccurrenceOf("=", false, false), ",", "");
+        values.trim();
+        values.removeEmptyStrings();
+
+        if (id.isEmpty() || values.isEmpty())
+        {
+            error = "Invalid sweep axis: " + axis;
+            return false;
+        }
+
+        // Settings the lanes do not model would give identical variants
+        if (id == "zeroCrossing" || id == "scListen" || id == "bypass")
+        {
+            error = "Cannot sweep " + id + ": sweep renders do not support it";
+            return false;
+        }
+
+        std::vector<SweepVariant> expanded;
+        for (auto& variant : result)
+        {
+            for (auto& value : values)
+            {
+                auto next = variant;
+                if (!next.settings.setParameter(id, value.getDoubleValue()))
+                {
+                    error = "Unknown parameter in sweep: " + id;
+                    return false;
+                }
+
+                next.name << (next.name.isEmpty() ? "" : "_") << id << value;
+                expanded.push_back(next);
+            }
+        }
+
+        result = std::move(expanded);
+    }
+
+    return true;
+}
+
+bool SweepRenderer::checkSupported(const DuckerSettings& settings, juce::String& error)
+{
+    if (settings.zeroCrossing || settings.scListen)
+    {
+        error = "Sweep renders do not support zeroCrossing or scListen; turn them off in the preset or with --set";
+        return false;
+    }
+
+    return true;
+}
+
+juce::File SweepRenderer::getVariantFile(const juce::File& outputFile, const SweepVariant& variant)
+{
+    return outputFile.getSiblingFile(juce::File::createLegalFileName(outputFile.getFileNameWithoutExtension()
+                                                                     + "_" + variant.name + ".wav"));
+}
+
+juce::File SweepRenderer::getSummaryFile(const juce::File& outputFile)
+{
+    return outputFile.getSiblingFile(outputFile.getFileNameWithoutExtension() + "_sweep.csv");
+}
+
+SweepRenderResult SweepRenderer::render(const RenderJob& job) const
+{
+    SweepRenderResult result;
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (auto& variant : variants)
+        if (!checkSupported(variant.settings, result.error))
+            return result;
+
+    RenderSources sources;
+    if (!renderer.openSources(sources, job, result.error))
+        return result;
+
+    auto sampleRate = sources.getSampleRate();
+    auto numChannels = sources.getNumChannels();
+    auto length = sources.getLengthInSamples();
+    auto blockSize = renderer.getBlockSize();
+    auto numVariants = (int)variants.size();
+
+    // Group variants by sidechain filter setting
+    std::vector<std::unique_ptr<FilterGroup>> groups;
+    std::vector<int> latency((size_t)numVariants);
+    int maxLatency = 0;
+
+    for (int v = 0; v < numVariants; ++v)
+    {
+        const auto& s = variants[(size_t)v].settings;
+        auto key = FilterKey::from(s);
+
+        auto it = std::find_if(groups.begin(), groups.end(), [&](const auto& g) { return g->key == key; });
+        if (it == groups.end())
+        {
+            auto group = std::make_unique<FilterGroup>();
+            group->key = key;
+            group->filter.prepare(sampleRate, blockSize);
+            group->filter.setHighPassFreq(s.scHPFFreq);
+            group->filter.setLowPassFreq(s.scLPFFreq);
+            group->filter.setHighPassEnabled(s.scHPFEnabled);
+            group->filter.setLowPassEnabled(s.scLPFEnabled);
+            groups.push_back(std::move(group));
+            it = groups.end() - 1;
+        }
+
+        (*it)->lanes.addLane(s, sampleRate);
+        (*it)->variantIndices.push_back(v);
+
+        // Same rounding as Ducker::updateLookAhead
+        latency[(size_t)v] = static_cast<int>(s.lookAhead * 0.001f * sampleRate);
+        maxLatency = juce::jmax(maxLatency, latency[(size_t)v]);
+    }
+
+    result.numFilterGroups = (int)groups.size();
+
+    // Per-variant gain blocks, referenced by each group's lane pointers
+    juce::AudioBuffer<float> gains(numVariants, blockSize);
+    for (auto& group : groups)
+        for (auto v : group->variantIndices)
+            group->gainPointers.push_back(gains.getWritePointer(v));
+
+    std::vector<std::unique_ptr<RenderOutput>> outputs;
+    for (auto& variant : variants)
+    {
+        outputs.push_back(renderer.createOutput(getVariantFile(job.outputFile, variant), sampleRate, numChannels, result.error));
+        if (outputs.back() == nullptr)
+            return result;
+    }
+
+    std::vector<StatsAccumulator> stats((size_t)numVariants);
+
+    juce::AudioBuffer<float> scBuffer(2, blockSize);
+    juce::AudioBuffer<float> keyBuffer(1, blockSize);
+    juce::AudioBuffer<float> mainBuffer(numChannels, blockSize + maxLatency);
+    juce::AudioBuffer<float> work(numChannels, blockSize);
+
+    // Key position p produces the gain for output sample p - latency
+    for (juce::int64 pos = 0; pos < length + maxLatency; pos += blockSize)
+    {
+        auto numSamples = (int)juce::jmin((juce::int64)blockSize, length + maxLatency - pos);
+
+        // Shared downmix of the key, as in Ducker::process
+        auto* mono = keyBuffer.getWritePointer(0);
+        if (sources.sidechain != nullptr)
+        {
+            auto scChannels = (int)juce::jmin(2u, sources.sidechain->numChannels);
+            sources.sidechain->read(&scBuffer, 0, numSamples, pos, true, scChannels > 1);
+            if (scChannels == 1)
+                scBuffer.copyFrom(1, 0, scBuffer, 0, 0, numSamples);
+        }
+        else
+        {
+            sources.main->read(&scBuffer, 0, numSamples, pos, true, numChannels > 1);
+            if (numChannels == 1)
+                scBuffer.copyFrom(1, 0, scBuffer, 0, 0, numSamples);
+        }
+
+        juce::FloatVectorOperations::add(mono, scBuffer.getReadPointer(0), scBuffer.getReadPointer(1), numSamples);
+        juce::FloatVectorOperations::multiply(mono, 0.5f, numSamples);
+
+        // Filter once per group, then step that group's lanes together
+        for (auto& group : groups)
+        {
+            auto* key = scBuffer.getWritePointer(0);
+            for (int i = 0; i < numSamples; ++i)
+                key[i] = std::abs(group->filter.processSample(mono[i]));
+
+            group->lanes.process(key, numSamples, group->gainPointers.data());
+        }
+
+        // Main samples [pos - maxLatency, pos + numSamples); negative
+        // positions are zero-filled by the reader
+        auto mainStart = pos - maxLatency;
+        sources.main->read(&mainBuffer, 0, numSamples + maxLatency, mainStart, true, numChannels > 1);
+
+        for (int v = 0; v < numVariants; ++v)
+        {
+            auto outStart = pos - latency[(size_t)v];
+            auto first = (int)juce::jmax((juce::int64)0, -outStart);
+            auto last = (int)juce::jmin((juce::int64)numSamples, length - outStart);
+            if (last <= first)
+                continue;
+
+            auto count = last - first;
+            auto mainOffset = (int)(outStart + first - mainStart);
+            auto* gain = gains.getReadPointer(v, first);
+
+            for (int ch = 0; ch < numChannels; ++ch)
+                juce::FloatVectorOperations::multiply(work.getWritePointer(ch), mainBuffer.getReadPointer(ch, mainOffset),
+                                                      gain, count);
+
+            outputs[(size_t)v]->write(work, 0, count);
+            stats[(size_t)v].add(gain, count);
+        }
+    }
+
+    outputs.clear(); // flush and close
+
+    for (auto& s : stats)
+        result.stats.push_back(s.get());
+
+    // CSV summary
+    juce::String csv = "variant,mean_gr_db,max_gr_db,ducked_percent\n";
+    for (int v = 0; v < numVariants; ++v)
+    {
+        const auto& s = result.stats[(size_t)v];
+        csv << variants[(size_t)v].name << ","
+            << juce::String(s.meanGainReductionDb, 3) << ","
+            << juce::String(s.maxGainReductionDb, 3) << ","
+            << juce::String(s.duckedFraction * 100.0, 2) << "\n";
+    }
+
+    if (!getSummaryFile(job.outputFile).replaceWithText(csv))
+    {
+        result.error = "Could not write " + getSummaryFile(job.outputFile).getFullPathName();
+        return result;
+    }
+
+    result.ok = true;
+    result.audioSeconds = (double)length / sampleRate;
+    result.wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    return result;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "OfflineRenderer.h"
+
+// One point of a parameter sweep
+struct SweepVariant
+{
+    DuckerSettings settings;
+    juce::String name;             // e.g. "threshold-24_attack5", used in file names
+};
+
+struct SweepStats
+{
+    double meanGainReductionDb = 0.0;
+    double maxGainReductionDb = 0.0;
+    double duckedFraction = 0.0;   // share of samples reduced by more than 1 dB
+};
+
+struct SweepRenderResult : RenderResult
+{
+    std::vector<SweepStats> stats; // one per variant
+    int numFilterGroups = 0;
+};
+
+// Renders every variant of a parameter grid in one pass over the files.
+//
+// The sidechain downmix is computed once per block and the filtered key
+// once per distinct filter setting. Each variant is then a lane of a
+// structure-of-arrays envelope: for each key sample, a filter group's lanes
+// run EnvelopeGenerator's state machine one after another, reading the
+// shared key sample and their own state from contiguous arrays. The state
+// switch is per lane, so lanes are not vectorised against each other; the
+// saving is the shared key, filtering and I/O. Look-ahead is applied per
+// variant by reading the main signal at that variant's offset, so each
+// output is aligned with the input like a normal render.
+// Zero-crossing gating and sidechain listen are not supported: expandGrid()
+// and render() fail if they are swept or on in the base settings.
+class SweepRenderer
+{
+public:
+    SweepRenderer(const OfflineRenderer& renderer, std::vector<SweepVariant> variants);
+
+    // Cartesian product of axes like "threshold=-30,-24,-18" over base
+    static bool expandGrid(const DuckerSettings& base, const juce::StringArray& axes,
+                           std::vector<SweepVariant>& variants, juce::String& error);
+
+    // Writes one file per variant next to job.outputFile, plus a CSV summary
+    SweepRenderResult render(const RenderJob& job) const;
+
+    // Fails for settings the lanes do not model (zeroCrossing, scListen)
+    static bool checkSupported(const DuckerSettings& settings, juce::String& error);
+
+    static juce::File getVariantFile(const juce::File& outputFile, const SweepVariant& variant);
+    static juce::File getSummaryFile(const juce::File& outputFile);
+
+    const std::vector<SweepVariant>& getVariants() const { return variants; }
+
+private:
+    const OfflineRenderer& renderer;
+    std::vector<SweepVariant> variants;
+};
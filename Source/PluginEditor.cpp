@@ -28,6 +28,17 @@ DuckerAudioProcessorEditor::DuckerAudioProcessorEditor(DuckerAudioProcessor& p)
     curveShapeLabel.setFont(juce::Font(11.0f));
     addAndMakeVisible(curveShapeLabel);
 
+    // Control output bus signal
+    controlSignalSelector.addItemList(juce::StringArray{ "Gain", "Envelope" }, 1);
+    controlSignalSelector.setSelectedItemIndex(0);
+    addAndMakeVisible(controlSignalSelector);
+
+    controlSignalLabel.setText("Control Out", juce::dontSendNotification);
+    controlSignalLabel.setJustificationType(juce::Justification::centred);
+    controlSignalLabel.setColour(juce::Label::textColourId, Colors::textSecondary);
+    controlSignalLabel.setFont(juce::Font(11.0f));
+    addAndMakeVisible(controlSignalLabel);
+
     // Bypass button
     setupButton(bypassButton, "Bypass");
 
@@ -62,13 +73,34 @@ DuckerAudioProcessorEditor::DuckerAudioProcessorEditor(DuckerAudioProcessor& p)
     releaseSyncLabel.setFont(juce::Font(11.0f));
     addAndMakeVisible(releaseSyncLabel);
 
+    // Envelope bus - one sender per name, receivers follow its detection
+    busRoleSelector.addItemList(juce::StringArray{ "No Bus", "Send", "Receive" }, 1);
+    busRoleSelector.setSelectedItemIndex((int)audioProcessor.getBusRole(), juce::dontSendNotification);
+    busRoleSelector.onChange = [this] { applyEnvelopeBus(); };
+    addAndMakeVisible(busRoleSelector);
+
+    busNameEditor.setText(audioProcessor.getBusName(), false);
+    busNameEditor.setTextToShowWhenEmpty("Bus name", Colors::textSecondary);
+    busNameEditor.setInputRestrictions(EnvelopeBus::maxNameLength);
+    busNameEditor.onReturnKey = [this] { applyEnvelopeBus(); };
+    busNameEditor.onFocusLost = [this] { applyEnvelopeBus(); };
+    addAndMakeVisible(busNameEditor);
+
     // Add meters
     addAndMakeVisible(inputMeter);
     addAndMakeVisible(outputMeter);
     addAndMakeVisible(grMeter);
 
-    // Add envelope display
+    // Add envelope display and waveform overview
     addAndMakeVisible(envelopeDisplay);
+    addAndMakeVisible(waveformOverview);
+
+    // Sidechain spectrum - analysis runs only while the editor is open
+    addAndMakeVisible(spectrumDisplay);
+    audioProcessor.getSidechainAnalyser().setActive(true);
+
+    // Diagnostics page, hidden until the title is double-clicked
+    addChildComponent(diagnosticsPanel);
 
     // Create attachments
     thresholdAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
@@ -89,6 +121,8 @@ DuckerAudioProcessorEditor::DuckerAudioProcessorEditor(DuckerAudioProcessor& p)
         audioProcessor.getAPVTS(), "mix", mixSlider);
     curveShapeAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
         audioProcessor.getAPVTS(), "curveShape", curveShapeSelector);
+    controlSignalAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+        audioProcessor.getAPVTS(), "controlSignal", controlSignalSelector);
     bypassAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
         audioProcessor.getAPVTS(), "bypass", bypassButton);
 
@@ -112,13 +146,12 @@ DuckerAudioProcessorEditor::DuckerAudioProcessorEditor(DuckerAudioProcessor& p)
     releaseSyncAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
         audioProcessor.getAPVTS(), "releaseSync", releaseSyncSelector);
 
-    setSize(700, 450);
-    startTimerHz(30);
+    setSize(700, 540);
 }
 
 DuckerAudioProcessorEditor::~DuckerAudioProcessorEditor()
 {
-    stopTimer();
+    audioProcessor.getSidechainAnalyser().setActive(false);
     setLookAndFeel(nullptr);
 }
 
@@ -165,6 +198,18 @@ void DuckerAudioProcessorEditor::paint(juce::Graphics& g)
     g.setFont(juce::Font(12.0f));
     g.drawText("Sidechain Ducker", 20, 32, 200, 16, juce::Justification::left);
 
+    // Envelope bus status under its controls
+    using BusStatus = DuckerAudioProcessor::BusStatus;
+    if (busStatus != BusStatus::off)
+    {
+        const char* text = busStatus == BusStatus::active    ? "Bus connected"
+                         : busStatus == BusStatus::nameInUse ? "Name already has a sender"
+                                                             : "Waiting for sender";
+        g.setColour(busStatus == BusStatus::active ? Colors::meterGreen : Colors::meterYellow);
+        g.setFont(juce::Font(10.0f));
+        g.drawText(text, 400, 36, 200, 12, juce::Justification::left);
+    }
+
     // Section labels
     g.setColour(Colors::accent);
     g.setFont(juce::Font(11.0f, juce::Font::bold));
@@ -218,6 +263,9 @@ void DuckerAudioProcessorEditor::resized()
     curveShapeSelector.setBounds(20, row2Y + knobSize + 25, 130, 24);
     curveShapeLabel.setBounds(20, row2Y + knobSize + 50, 130, labelHeight);
 
+    controlSignalSelector.setBounds(170, row2Y + knobSize + 25, 130, 24);
+    controlSignalLabel.setBounds(170, row2Y + knobSize + 50, 130, labelHeight);
+
     // Sidechain section
     int scX = 360;
     scHPFSlider.setBounds(scX, row1Y, knobSize - 10, knobSize - 10);
@@ -243,9 +291,22 @@ void DuckerAudioProcessorEditor::resized()
     // Bypass button
     bypassButton.setBounds(getWidth() - 90, 12, 70, 26);
 
+    // Envelope bus (status text is painted below)
+    busRoleSelector.setBounds(400, 10, 84, 24);
+    busNameEditor.setBounds(490, 10, 110, 24);
+
     // Envelope display
     envelopeDisplay.setBounds(20, 360, 460, 75);
 
+    // Sidechain spectrum
+    spectrumDisplay.setBounds(scX, 272, 245, 80);
+
+    // Waveform overview
+    waveformOverview.setBounds(20, 445, getWidth() - 40, 85);
+
+    // Diagnostics overlay
+    diagnosticsPanel.setBounds(20, 290, 420, 240);
+
     // Meters
     int meterWidth = 16;
     int meterHeight = 280;
@@ -255,41 +316,85 @@ void DuckerAudioProcessorEditor::resized()
     outputMeter.setBounds(getWidth() - 30, meterY, meterWidth, meterHeight);
 }
 
-void DuckerAudioProcessorEditor::timerCallback()
+void DuckerAudioProcessorEditor::mouseDoubleClick(const juce::MouseEvent& e)
+{
+    // The title toggles the hidden diagnostics page
+    if (juce::Rectangle<int>(20, 10, 200, 40).contains(e.getPosition()))
+    {
+        diagnosticsPanel.setVisible(!diagnosticsPanel.isVisible());
+        diagnosticsPanel.toFront(false);
+    }
+}
+
+void DuckerAudioProcessorEditor::applyEnvelopeBus()
 {
+    audioProcessor.setEnvelopeBus((DuckerAudioProcessor::BusRole)juce::jmax(0, busRoleSelector.getSelectedItemIndex()),
+                                  busNameEditor.getText());
+}
+
+void DuckerAudioProcessorEditor::onVBlank()
+{
+    // Bus status only changes when a sender appears or goes away
+    if (auto status = audioProcessor.getBusStatus(); status != busStatus)
+    {
+        busStatus = status;
+        repaint(400, 34, 200, 16);
+    }
+
+    // Ballistics are driven by elapsed time rather than a fixed tick rate
+    auto nowMs = juce::Time::getMillisecondCounterHiRes();
+    auto elapsedSeconds = lastVBlankMs > 0.0 ? (nowMs - lastVBlankMs) * 0.001 : 0.0;
+    lastVBlankMs = nowMs;
+
+    // Drain every telemetry frame published since the last frame
+    float targetIn = 0.0f;
+    float targetOut = 0.0f;
+    float targetGR = 0.0f;
+    bool triggered = false;
+
+    audioProcessor.getTelemetry().drain([&](const TelemetryFrame& frame)
+    {
+        targetIn = juce::jmax(targetIn, frame.inputLevel);
+        targetOut = juce::jmax(targetOut, frame.outputLevel);
+        targetGR = juce::jmax(targetGR, frame.gainReductionDb);
+        triggered = triggered || frame.triggered;
+        envelopeDisplay.pushFrame(frame);
+        waveformOverview.pushFrame(frame);
+    });
+
     // Smooth level metering
-    float targetIn = audioProcessor.getInputLevel();
-    float targetOut = audioProcessor.getOutputLevel();
-    float targetGR = audioProcessor.getGainReduction();
-
-    smoothedInputLevel = smoothedInputLevel * 0.8f + targetIn * 0.2f;
-    smoothedOutputLevel = smoothedOutputLevel * 0.8f + targetOut * 0.2f;
-    smoothedGR = smoothedGR * 0.8f + targetGR * 0.2f;
-
-    // Faster decay when signal drops
-    if (targetIn < smoothedInputLevel)
-        smoothedInputLevel *= 0.92f;
-    if (targetOut < smoothedOutputLevel)
-        smoothedOutputLevel *= 0.92f;
-    if (targetGR < smoothedGR)
-        smoothedGR *= 0.92f;
+    float smoothedInputLevel = inputBallistics.process(targetIn, elapsedSeconds);
+    float smoothedOutputLevel = outputBallistics.process(targetOut, elapsedSeconds);
+    float smoothedGR = grBallistics.process(targetGR, elapsedSeconds);
 
     inputMeter.setLevel(smoothedInputLevel);
     outputMeter.setLevel(smoothedOutputLevel);
     grMeter.setGainReduction(smoothedGR);
 
     // Update envelope display
-    envelopeDisplay.setEnvelopeValue(audioProcessor.getEnvelopeValue());
+    waveformOverview.setSampleRate(audioProcessor.getSampleRate());
+    envelopeDisplay.setSampleRate(audioProcessor.getSampleRate());
     envelopeDisplay.setAttackMs(attackSlider.getValue());
     envelopeDisplay.setHoldMs(holdSlider.getValue());
     envelopeDisplay.setReleaseMs(releaseSlider.getValue());
     envelopeDisplay.setDuckAmount((float)duckAmountSlider.getValue());
     envelopeDisplay.setCurveShape(curveShapeSelector.getSelectedItemIndex());
-    envelopeDisplay.setTriggered(audioProcessor.isTriggered());
-
-    // Repaint meters and display
-    inputMeter.repaint();
-    outputMeter.repaint();
-    grMeter.repaint();
-    envelopeDisplay.repaint();
+    envelopeDisplay.setTriggered(triggered);
+
+    // Meters invalidate only the rows that changed; the envelope display
+    // coalesces everything that changed this frame into one repaint
+    envelopeDisplay.flush();
+    waveformOverview.flush();
+
+    // Filter response is only re-evaluated when these settings change
+    auto& apvts = audioProcessor.getAPVTS();
+    spectrumDisplay.setFilters(audioProcessor.getSampleRate(),
+                               apvts.getRawParameterValue("scHPFFreq")->load(),
+                               apvts.getRawParameterValue("scHPFEnabled")->load() > 0.5f,
+                               apvts.getRawParameterValue("scLPFFreq")->load(),
+                               apvts.getRawParameterValue("scLPFEnabled")->load() > 0.5f);
+    spectrumDisplay.update(audioProcessor.getSidechainAnalyser());
+
+    // Stage timings are drained even while hidden so the FIFO never backs up
+    diagnosticsPanel.update(audioProcessor.getStageProfile(), audioProcessor.getSampleRate());
 }
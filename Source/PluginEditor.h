@@ -5,9 +5,11 @@
 #include "UI/LookAndFeel.h"
 #include "UI/MeterComponents.h"
 #include "UI/EnvelopeDisplay.h"
+#include "UI/WaveformOverview.h"
+#include "UI/SpectrumDisplay.h"
+#include "UI/DiagnosticsPanel.h"
 
-class DuckerAudioProcessorEditor : public juce::AudioProcessorEditor,
-                                    public juce::Timer
+class DuckerAudioProcessorEditor : public juce::AudioProcessorEditor
 {
 public:
     DuckerAudioProcessorEditor(DuckerAudioProcessor&);
@@ -15,7 +17,7 @@ public:
 
     void paint(juce::Graphics&) override;
     void resized() override;
-    void timerCallback() override;
+    void mouseDoubleClick(const juce::MouseEvent&) override;
 
 private:
     DuckerAudioProcessor& audioProcessor;
@@ -28,6 +30,7 @@ private:
     juce::Slider attackSlider, holdSlider, releaseSlider;
     juce::Slider rangeSlider, lookAheadSlider, mixSlider;
     juce::ComboBox curveShapeSelector;
+    juce::ComboBox controlSignalSelector;
     juce::ToggleButton bypassButton;
 
     // Sidechain controls
@@ -40,11 +43,17 @@ private:
     juce::ToggleButton tempoSyncButton;
     juce::ComboBox holdSyncSelector, releaseSyncSelector;
 
+    // Envelope bus role and name (header)
+    juce::ComboBox busRoleSelector;
+    juce::TextEditor busNameEditor;
+    DuckerAudioProcessor::BusStatus busStatus = DuckerAudioProcessor::BusStatus::off;
+
     // Labels
     juce::Label thresholdLabel, duckAmountLabel;
     juce::Label attackLabel, holdLabel, releaseLabel;
     juce::Label rangeLabel, lookAheadLabel, mixLabel;
     juce::Label curveShapeLabel;
+    juce::Label controlSignalLabel;
     juce::Label scHPFLabel, scLPFLabel;
     juce::Label holdSyncLabel, releaseSyncLabel;
 
@@ -55,10 +64,18 @@ private:
     // Envelope display
     EnvelopeDisplay envelopeDisplay;
 
+    // Key/main/gain waveform overview
+    WaveformOverview waveformOverview;
+
+    // Sidechain spectrum with filter response
+    SpectrumDisplay spectrumDisplay;
+
+    // Hidden per-stage timing page (double-click the title)
+    DiagnosticsPanel diagnosticsPanel;
+
     // Smoothed metering values
-    float smoothedInputLevel = 0.0f;
-    float smoothedOutputLevel = 0.0f;
-    float smoothedGR = 0.0f;
+    MeterBallistics inputBallistics, outputBallistics, grBallistics;
+    double lastVBlankMs = 0.0;
 
     // APVTS Attachments
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> thresholdAttachment;
@@ -70,6 +87,7 @@ private:
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> lookAheadAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> mixAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> curveShapeAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> controlSignalAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> bypassAttachment;
 
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> scHPFAttachment;
@@ -85,6 +103,11 @@ private:
 
     void setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& name);
     void setupButton(juce::ToggleButton& button, const juce::String& name);
+    void onVBlank();
+    void applyEnvelopeBus();
+
+    // Display-synchronised UI updates (declared last so it detaches first)
+    juce::VBlankAttachment vblankAttachment { this, [this] { onVBlank(); } };
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(DuckerAudioProcessorEditor)
 };
@@ -5,7 +5,8 @@ DuckerAudioProcessor::DuckerAudioProcessor()
      : AudioProcessor(BusesProperties()
                       .withInput("Input", juce::AudioChannelSet::stereo(), true)
                       .withInput("Sidechain", juce::AudioChannelSet::stereo(), true)
-                      .withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+                      .withOutput("Output", juce::AudioChannelSet::stereo(), true)
+                      .withOutput("Control", juce::AudioChannelSet::mono(), false)),
        apvts(*this, nullptr, "Parameters", createParameterLayout())
 {
     // Cache parameter pointers
@@ -30,10 +31,14 @@ DuckerAudioProcessor::DuckerAudioProcessor()
     tempoSync = apvts.getRawParameterValue("tempoSync");
     holdSync = apvts.getRawParameterValue("holdSync");
     releaseSync = apvts.getRawParameterValue("releaseSync");
+
+    controlSignal = apvts.getRawParameterValue("controlSignal");
 }
 
 DuckerAudioProcessor::~DuckerAudioProcessor()
 {
+    if (auto* channel = busChannel.exchange(nullptr); channel != nullptr && busRoleSetting == BusRole::send)
+        channel->releaseSender();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout DuckerAudioProcessor::createParameterLayout()
@@ -133,6 +138,11 @@ juce::AudioProcessorValueTreeState::ParameterLayout DuckerAudioProcessor::create
         juce::ParameterID("releaseSync", 1), "Release Sync",
         juce::StringArray{ "1/64", "1/32", "1/16T", "1/16", "1/8T", "1/8", "1/4T", "1/4", "1/2", "1 Bar" }, 5));
 
+    // What the "Control" output bus carries, when the host enables it
+    params.push_back(std::make_unique<juce::AudioParameterChoice>(
+        juce::ParameterID("controlSignal", 1), "Control Out",
+        juce::StringArray{ "Gain", "Envelope" }, 0));
+
     return { params.begin(), params.end() };
 }
 
@@ -151,10 +161,20 @@ void DuckerAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     currentSampleRate = sampleRate;
     ducker.prepare(sampleRate, samplesPerBlock);
+    sidechainAnalyser.prepare(sampleRate);
 
     // Allocate sidechain buffer
     sidechainBuffer.setSize(2, samplesPerBlock);
 
+    busEnvelope.assign((size_t)samplesPerBlock, 0.0f);
+    busDelaySamples = samplesPerBlock;
+    busHoldSamples = (int)(0.1 * sampleRate);
+    busHeldEnvelope = 0.0f;
+    busMissingSamples = busHoldSamples;
+    busKeyDelay.setSize(2, busDelaySamples);
+    busKeyDelay.clear();
+    busKeyDelayPosition = 0;
+
     // Report latency for look-ahead compensation
     setLatencySamples(ducker.getLatencyInSamples());
 }
@@ -182,14 +202,30 @@ bool DuckerAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) co
         && scChannels != juce::AudioChannelSet::stereo())
         return false;
 
+    // Control output likewise
+    auto controlChannels = layouts.getChannelSet(false, 1);
+    if (!controlChannels.isDisabled()
+        && controlChannels != juce::AudioChannelSet::mono()
+        && controlChannels != juce::AudioChannelSet::stereo())
+        return false;
+
     return true;
 }
 
 void DuckerAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    // No-op unless built with DUCKER_RT_SAFETY
+    RealtimeSafety::ScopedAudioThread realtimeGuard(buffer.getNumSamples(), currentSampleRate);
+
     juce::ignoreUnused(midiMessages);
     juce::ScopedNoDenormals noDenormals;
 
+    // No-op unless built with DUCKER_PROFILING
+    auto& profiler = ducker.getProfiler();
+    profiler.beginBlock();
+    trace.beginBlock();
+    liveStats.beginBlock();
+
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -197,15 +233,27 @@ void DuckerAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
+    // Control output: the applied gain (1 = untouched) or the detector
+    // envelope (1 = fully ducked), aligned with the main output. Its
+    // channels share the buffer with the sidechain input, so it is only
+    // written once the sidechain has been copied out.
+    auto controlBus = getBusBuffer(buffer, false, 1);
+    auto controlIsEnvelope = controlSignal->load() > 0.5f;
+    float* control = controlBus.getNumChannels() > 0 ? controlBus.getWritePointer(0) : nullptr;
+
     // Check bypass
     if (bypass->load() > 0.5f)
+    {
+        if (control != nullptr)
+            for (int ch = 0; ch < controlBus.getNumChannels(); ++ch)
+                juce::FloatVectorOperations::fill(controlBus.getWritePointer(ch), controlIsEnvelope ? 0.0f : 1.0f,
+                                                  buffer.getNumSamples());
+
+        profiler.endBlock(buffer.getNumSamples());
+        trace.endBlock(buffer.getNumSamples(), currentSampleRate);
+        publishLiveStats(buffer.getNumSamples());
         return;
-
-    // Measure input level
-    float inLevel = 0.0f;
-    for (int ch = 0; ch < juce::jmin(2, (int)totalNumInputChannels); ++ch)
-        inLevel = std::max(inLevel, buffer.getMagnitude(ch, 0, buffer.getNumSamples()));
-    inputLevel.store(inLevel);
+    }
 
     // Get sidechain input
     auto mainBus = getBusBuffer(buffer, true, 0);
@@ -231,6 +279,13 @@ void DuckerAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::
         }
     }
 
+    // Hand the key signal to the spectrum analyser (wait-free)
+    sidechainAnalyser.pushSamples(sidechainBuffer.getReadPointer(0), sidechainBuffer.getReadPointer(1),
+                                  buffer.getNumSamples());
+
+    profiler.lap(StageProfiling::sidechainCopy);
+    trace.lap(Tracing::sidechainCopy);
+
     // Calculate tempo-synced times if enabled
     float holdTimeMs = hold->load();
     float releaseTimeMs = release->load();
@@ -246,14 +301,11 @@ void DuckerAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::
                 double bpm = *position->getBpm();
                 double beatLengthMs = 60000.0 / bpm;
 
-                // Note divisions: 1/64, 1/32, 1/16T, 1/16, 1/8T, 1/8, 1/4T, 1/4, 1/2, 1 Bar
-                const float divisions[] = { 0.0625f, 0.125f, 0.167f, 0.25f, 0.333f, 0.5f, 0.667f, 1.0f, 2.0f, 4.0f };
-
                 int holdIdx = static_cast<int>(holdSync->load());
                 int releaseIdx = static_cast<int>(releaseSync->load());
 
-                holdTimeMs = static_cast<float>(beatLengthMs * divisions[holdIdx]);
-                releaseTimeMs = static_cast<float>(beatLengthMs * divisions[releaseIdx]);
+                holdTimeMs = static_cast<float>(beatLengthMs * DSPUtils::getSyncDivisionBeats(holdIdx));
+                releaseTimeMs = static_cast<float>(beatLengthMs * DSPUtils::getSyncDivisionBeats(releaseIdx));
             }
         }
     }
@@ -276,17 +328,169 @@ void DuckerAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::
     ducker.setSidechainListen(scListen->load() > 0.5f);
     ducker.setZeroCrossingEnabled(zeroCrossing->load() > 0.5f);
 
+    // Bus state for this block, read once so the delay and the data match.
+    // Receivers delay their audio by the block they read behind.
+    auto* channel = busChannel.load(std::memory_order_acquire);
+    auto role = channel != nullptr ? (BusRole)busRole.load() : BusRole::off;
+    ducker.setExtraDelay(role == BusRole::receive ? busDelaySamples : 0);
+
     // Update latency if look-ahead changed
     setLatencySamples(ducker.getLatencyInSamples());
 
-    // Process ducking
-    ducker.process(mainBus, sidechainBuffer);
+    profiler.lap(StageProfiling::parameters);
+    trace.lap(Tracing::parameters);
+
+    // Process ducking (also publishes level/envelope telemetry). The
+    // control signal is written from the same per-sample loop.
+    processWithBus(mainBus, buffer.getNumSamples(), channel, role, sidechainBus.getNumChannels() > 0,
+                   controlIsEnvelope ? nullptr : control, controlIsEnvelope ? control : nullptr);
+
+    for (int ch = 1; ch < controlBus.getNumChannels(); ++ch)
+        controlBus.copyFrom(ch, 0, controlBus, 0, 0, buffer.getNumSamples());
 
-    // Measure output level
-    float outLevel = 0.0f;
-    for (int ch = 0; ch < juce::jmin(2, (int)totalNumInputChannels); ++ch)
-        outLevel = std::max(outLevel, mainBus.getMagnitude(ch, 0, mainBus.getNumSamples()));
-    outputLevel.store(outLevel);
+    trace.lap(Tracing::duckerProcess);
+    profiler.endBlock(buffer.getNumSamples());
+    trace.endBlock(buffer.getNumSamples(), currentSampleRate);
+    publishLiveStats(buffer.getNumSamples());
+}
+
+void DuckerAudioProcessor::processWithBus(juce::AudioBuffer<float>& mainBus, int numSamples,
+                                          EnvelopeBus::Channel* channel, BusRole role, bool hasSidechain,
+                                          float* controlGain, float* controlEnvelope)
+{
+    // A receiver's audio runs one block late (see processBlock), so its key
+    // does too: every fallback to local detection then ducks on time, and
+    // the reported latency stays the same whichever path a block takes
+    if (role == BusRole::receive)
+        delayReceiverKey(numSamples);
+
+    if (role == BusRole::off || numSamples > (int)busEnvelope.size())
+    {
+        busReceiving.store(false, std::memory_order_relaxed);
+        ducker.process(mainBus, sidechainBuffer, controlGain, controlEnvelope);
+        return;
+    }
+
+    // Sample-accurate alignment needs the host timeline; with the transport
+    // stopped the sender free-runs and receivers follow its latest block
+    juce::Optional<juce::int64> timeline;
+    if (auto* playHead = getPlayHead())
+        if (auto position = playHead->getPosition(); position.hasValue() && position->getIsPlaying())
+            if (auto samples = position->getTimeInSamples(); samples.hasValue())
+                timeline = *samples;
+
+    if (role == BusRole::send)
+    {
+        auto* envelope = controlEnvelope != nullptr ? controlEnvelope : busEnvelope.data();
+        ducker.process(mainBus, sidechainBuffer, controlGain, envelope);
+
+        auto position = timeline.orFallback(busFreePosition);
+        channel->write(position, envelope, numSamples);
+        busFreePosition = position + numSamples;
+        return;
+    }
+
+    auto from = timeline.hasValue() ? *timeline - busDelaySamples : channel->getWriteEnd() - numSamples;
+    auto received = channel->read(from, busEnvelope.data(), numSamples);
+    busReceiving.store(received, std::memory_order_relaxed);
+
+    if (received)
+    {
+        busHeldEnvelope = busEnvelope[(size_t)numSamples - 1];
+        busMissingSamples = 0;
+    }
+    else if (hasSidechain)
+    {
+        // A routed key of its own: detect locally until the sender is back
+        ducker.process(mainBus, sidechainBuffer, controlGain, controlEnvelope);
+        return;
+    }
+    else
+    {
+        // No key of its own (the sidechain buffer is this track's main
+        // input). Seeks and loop restarts leave a gap while the sender starts
+        // a new range: hold the last value across it, then stop ducking.
+        auto held = busMissingSamples < busHoldSamples ? busHeldEnvelope : 0.0f;
+        juce::FloatVectorOperations::fill(busEnvelope.data(), held, numSamples);
+        busMissingSamples += numSamples;
+    }
+
+    ducker.process(mainBus, sidechainBuffer, controlGain, controlEnvelope, busEnvelope.data());
+}
+
+void DuckerAudioProcessor::setEnvelopeBus(BusRole role, const juce::String& name)
+{
+    auto busName = name.trim().substring(0, EnvelopeBus::maxNameLength);
+    if (role == busRoleSetting && busName == busNameSetting && busChannel.load() != nullptr)
+        return;
+
+    // Channels outlive every instance, so the audio thread may finish its
+    // current block on the previous one
+    if (auto* previous = busChannel.exchange(nullptr); previous != nullptr && busRoleSetting == BusRole::send)
+        previous->releaseSender();
+
+    busRoleSetting = role;
+    busNameSetting = busName;
+    busNameInUse = false;
+    busReceiving.store(false);
+
+    apvts.state.setProperty("busRole", (int)role, nullptr);
+    apvts.state.setProperty("busName", busNameSetting, nullptr);
+
+    if (role == BusRole::off)
+        return;
+
+    auto* channel = busRegistry->getChannel(busNameSetting);
+    if (channel == nullptr)
+        return;
+
+    if (role == BusRole::send && !channel->claimSender())
+    {
+        busNameInUse = true;
+        return;
+    }
+
+    busRole.store((int)role);
+    busChannel.store(channel, std::memory_order_release);
+}
+
+DuckerAudioProcessor::BusStatus DuckerAudioProcessor::getBusStatus() const
+{
+    if (busRoleSetting == BusRole::off)
+        return BusStatus::off;
+    if (busNameInUse)
+        return BusStatus::nameInUse;
+    if (busChannel.load() == nullptr || (busRoleSetting == BusRole::receive && !busReceiving.load()))
+        return BusStatus::waiting;
+    return BusStatus::active;
+}
+
+void DuckerAudioProcessor::delayReceiverKey(int numSamples) noexcept
+{
+    auto length = busKeyDelay.getNumSamples();
+    if (length == 0)
+        return;
+
+    for (int ch = 0; ch < sidechainBuffer.getNumChannels(); ++ch)
+    {
+        auto* key = sidechainBuffer.getWritePointer(ch);
+        auto* line = busKeyDelay.getWritePointer(ch);
+        auto position = busKeyDelayPosition;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            std::swap(key[i], line[position]);
+            position = position + 1 == length ? 0 : position + 1;
+        }
+    }
+
+    busKeyDelayPosition = (int)((busKeyDelayPosition + numSamples) % length);
+}
+
+void DuckerAudioProcessor::publishLiveStats(int numSamples) noexcept
+{
+    const auto& counters = ducker.getCounters();
+    liveStats.endBlock(numSamples, currentSampleRate, counters.triggers, counters.duckedSamples);
 }
 
 bool DuckerAudioProcessor::hasEditor() const
@@ -310,7 +514,11 @@ void DuckerAudioProcessor::setStateInformation(const void* data, int sizeInBytes
 {
     std::unique_ptr<juce::XmlElement> xml(getXmlFromBinary(data, sizeInBytes));
     if (xml != nullptr && xml->hasTagName(apvts.state.getType()))
+    {
         apvts.replaceState(juce::ValueTree::fromXml(*xml));
+        setEnvelopeBus((BusRole)(int)apvts.state.getProperty("busRole", 0),
+                       apvts.state.getProperty("busName").toString());
+    }
 }
 
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
@@ -2,6 +2,11 @@
 
 #include <JuceHeader.h>
 #include "DSP/Ducker.h"
+#include "DSP/EnvelopeBus.h"
+#include "Analysis/SpectrumAnalyser.h"
+#include "Diagnostics/RealtimeSafety.h"
+#include "Diagnostics/TraceRecorder.h"
+#include "Diagnostics/LiveStats.h"
 
 class DuckerAudioProcessor : public juce::AudioProcessor
 {
@@ -37,23 +42,71 @@ public:
     // Public API for editor access
     juce::AudioProcessorValueTreeState& getAPVTS() { return apvts; }
 
-    // Metering accessors
-    float getInputLevel() const { return inputLevel.load(); }
-    float getOutputLevel() const { return outputLevel.load(); }
-    float getGainReduction() const { return ducker.getGainReduction(); }
-    float getEnvelopeValue() const { return ducker.getEnvelopeValue(); }
-    bool isTriggered() const { return ducker.isTriggered(); }
+    // Metering - per-sub-block frames published by the audio thread,
+    // drained by the editor (single consumer)
+    TelemetryFifo& getTelemetry() { return ducker.getTelemetry(); }
+
+    // Per-stage timing frames (empty unless built with DUCKER_PROFILING),
+    // drained by the editor's diagnostics panel
+    StageProfiling::Fifo& getStageProfile() { return ducker.getProfiler().getFifo(); }
+
+    // Sidechain spectrum (analysis runs on its own thread while an editor is open)
+    SpectrumAnalyser& getSidechainAnalyser() { return sidechainAnalyser; }
+
+    // Envelope bus (DSP/EnvelopeBus.h): publish this instance's detected
+    // envelope under a name, or follow one instead of detecting. Saved with
+    // the state; message thread only.
+    enum class BusRole { off, send, receive };
+    enum class BusStatus { off, active, waiting, nameInUse };
+
+    void setEnvelopeBus(BusRole role, const juce::String& name);
+    BusRole getBusRole() const { return busRoleSetting; }
+    juce::String getBusName() const { return busNameSetting; }
+    BusStatus getBusStatus() const;
 
 private:
     juce::AudioProcessorValueTreeState apvts;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
 
+    void publishLiveStats(int numSamples) noexcept;
+    void delayReceiverKey(int numSamples) noexcept;
+    void processWithBus(juce::AudioBuffer<float>& mainBus, int numSamples,
+                        EnvelopeBus::Channel* channel, BusRole role, bool hasSidechain,
+                        float* controlGain, float* controlEnvelope);
+
     // DSP Module
     Ducker ducker;
 
     // Sidechain buffer
     juce::AudioBuffer<float> sidechainBuffer;
 
+    // Sidechain spectrum analyser
+    SpectrumAnalyser sidechainAnalyser;
+
+    // Envelope bus. The audio thread sees busChannel/busRole; the *Setting
+    // members are the message thread's view.
+    juce::SharedResourcePointer<EnvelopeBus::Registry> busRegistry;
+    std::atomic<EnvelopeBus::Channel*> busChannel { nullptr };
+    std::atomic<int> busRole { 0 };
+    std::atomic<bool> busReceiving { false };
+    BusRole busRoleSetting = BusRole::off;
+    juce::String busNameSetting;
+    bool busNameInUse = false;
+    std::vector<float> busEnvelope;
+    juce::int64 busFreePosition = 0;    // sender position while the transport is stopped
+    int busDelaySamples = 0;            // receivers: one block
+    float busHeldEnvelope = 0.0f;       // receivers: last value read
+    int busMissingSamples = 0;          // receivers: since the last read
+    int busHoldSamples = 0;             // receivers: how long to hold across a gap
+    juce::AudioBuffer<float> busKeyDelay;   // receivers: key history, so local detection
+    int busKeyDelayPosition = 0;            // lines up with the block-delayed audio
+
+    // Block timeline for Chrome/Perfetto traces (inactive unless DUCKER_TRACE is set)
+    Tracing::TraceBuffer trace;
+
+    // Shared-memory counters for ducker_stats (inactive unless DUCKER_STATS is set)
+    LiveStats::Publisher liveStats;
+
     // Parameter pointers (cached for fast access)
     std::atomic<float>* threshold = nullptr;
     std::atomic<float>* duckAmount = nullptr;
@@ -77,9 +130,7 @@ private:
     std::atomic<float>* holdSync = nullptr;
     std::atomic<float>* releaseSync = nullptr;
 
-    // Metering state
-    std::atomic<float> inputLevel { 0.0f };
-    std::atomic<float> outputLevel { 0.0f };
+    std::atomic<float>* controlSignal = nullptr;
 
     // Runtime
     double currentSampleRate = 44100.0;
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "LookAndFeel.h"
+#include "../DSP/StageProfiler.h"
+
+// Hidden diagnostics page: per-stage min/mean/p99 cost of the audio path over
+// the last windowSize blocks, in ns per sample and as a share of the block's
+// real-time budget. Frames arrive through the processor's wait-free stage
+// FIFO; the window is aggregated here on the message thread, a few times a
+// second so the figures stay readable.
+class DiagnosticsPanel : public juce::Component
+{
+public:
+    static constexpr int windowSize = 1024;
+
+    // Drain the FIFO every frame (so it never fills) but re-aggregate only
+    // every refreshMs while visible
+    void update(StageProfiling::Fifo& fifo, double sampleRate)
+    {
+        fifo.drain([this](const StageProfiling::Frame& frame)
+        {
+            if (frame.numSamples <= 0)
+                return;
+
+            for (int s = 0; s < StageProfiling::numStages; ++s)
+                window[(size_t)s][(size_t)writeIndex] = (float)frame.ticks[(size_t)s] / (float)frame.numSamples;
+
+            writeIndex = (writeIndex + 1) % windowSize;
+            numFrames = juce::jmin(numFrames + 1, windowSize);
+        });
+
+        currentSampleRate = sampleRate;
+
+        auto nowMs = juce::Time::getMillisecondCounterHiRes();
+        if (!isVisible() || nowMs - lastRefreshMs < refreshMs)
+            return;
+
+        lastRefreshMs = nowMs;
+        aggregate();
+        repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat();
+
+        g.setColour(juce::Colour(0xf0151515));
+        g.fillRoundedRectangle(bounds, 4.0f);
+        g.setColour(juce::Colour(0xff303030));
+        g.drawRoundedRectangle(bounds.reduced(0.5f), 4.0f, 1.0f);
+
+        auto area = getLocalBounds().reduced(10, 8);
+
+        g.setColour(Colors::accent);
+        g.setFont(juce::Font(11.0f, juce::Font::bold));
+        g.drawText("DIAGNOSTICS", area.removeFromTop(16), juce::Justification::left);
+
+        g.setFont(juce::Font(11.0f));
+
+        if (!StageProfiling::enabled)
+        {
+            g.setColour(Colors::textSecondary);
+            g.drawText("Stage timers are compiled out. Build with DUCKER_PROFILING=1.",
+                       area.removeFromTop(18), juce::Justification::left);
+            return;
+        }
+
+        auto nsPerTick = ticksPerSecond > 0.0 ? 1.0e9 / ticksPerSecond : 0.0;
+        auto budgetNs = currentSampleRate > 0.0 ? 1.0e9 / currentSampleRate : 0.0;
+
+        g.setColour(Colors::textSecondary);
+        g.drawText(juce::String(numFrames) + " blocks, budget " + juce::String(budgetNs, 0) + " ns/sample"
+                       + (nsPerTick > 0.0 ? juce::String() : juce::String("  (calibrating clock...)")),
+                   area.removeFromTop(16), juce::Justification::left);
+
+        area.removeFromTop(4);
+
+        const int columns[] = { 90, 70, 70, 70, 70 };
+        auto drawRow = [&](const juce::StringArray& cells, juce::Colour colour)
+        {
+            auto row = area.removeFromTop(16);
+            g.setColour(colour);
+            for (int c = 0; c < cells.size(); ++c)
+                g.drawText(cells[c], row.removeFromLeft(columns[c]),
+                           c == 0 ? juce::Justification::left : juce::Justification::right);
+        };
+
+        drawRow({ "Stage", "min ns", "mean ns", "p99 ns", "p99 load" }, Colors::textSecondary);
+
+        for (int s = 0; s < StageProfiling::numStages; ++s)
+        {
+            auto& st = stats[(size_t)s];
+            auto toNs = [&](float ticks) { return juce::String(ticks * nsPerTick, 1); };
+            auto load = budgetNs > 0.0 ? st.p99 * nsPerTick / budgetNs * 100.0 : 0.0;
+
+            // Per-sample stages are upper bounds (see StageProfiler.h)
+            auto perSample = s >= StageProfiling::sidechainFilter && s <= StageProfiling::metering;
+            auto name = juce::String(StageProfiling::getStageName(s)) + (perSample ? " *" : "");
+
+            drawRow({ name, toNs(st.min), toNs(st.mean), toNs(st.p99), juce::String(load, 2) + "%" },
+                    s == StageProfiling::block ? Colors::textPrimary : Colors::textSecondary);
+        }
+
+        area.removeFromTop(4);
+        g.setColour(Colors::textSecondary.withAlpha(0.7f));
+        g.drawText("* Upper bounds: timed every " + juce::String(StageProfiling::sampleStride)
+                       + "th sample, counter cost subtracted. Compare, don't add up.",
+                   area.removeFromTop(14), juce::Justification::left);
+        g.drawText("Double-click the title to close.", area.removeFromTop(14), juce::Justification::left);
+    }
+
+private:
+    struct StageStats
+    {
+        float min = 0.0f, mean = 0.0f, p99 = 0.0f;   // ticks per sample
+    };
+
+    void aggregate()
+    {
+        ticksPerSecond = tickRate.getTicksPerSecond();
+
+        for (int s = 0; s < StageProfiling::numStages; ++s)
+        {
+            auto& values = window[(size_t)s];
+            auto& st = stats[(size_t)s];
+
+            if (numFrames == 0)
+            {
+                st = {};
+                continue;
+            }
+
+            std::copy(values.begin(), values.begin() + numFrames, scratch.begin());
+            auto* first = scratch.data();
+            auto* last = first + numFrames;
+
+            st.min = *std::min_element(first, last);
+            st.mean = std::accumulate(first, last, 0.0f) / (float)numFrames;
+
+            auto* p99 = first + juce::jmin(numFrames - 1, (int)std::ceil(0.99 * numFrames) - 1);
+            std::nth_element(first, p99, last);
+            st.p99 = *p99;
+        }
+    }
+
+    static constexpr double refreshMs = 250.0;
+
+    std::array<std::array<float, windowSize>, StageProfiling::numStages> window {};
+    std::array<float, windowSize> scratch {};
+    std::array<StageStats, StageProfiling::numStages> stats {};
+    int writeIndex = 0;
+    int numFrames = 0;
+
+    StageProfiling::TickRate tickRate;
+    double ticksPerSecond = 0.0;
+    double currentSampleRate = 44100.0;
+    double lastRefreshMs = 0.0;
+};
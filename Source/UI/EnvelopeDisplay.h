@@ -3,34 +3,176 @@
 #include <JuceHeader.h>
 #include "LookAndFeel.h"
 #include "../DSP/DSPUtils.h"
+#include "../DSP/Telemetry.h"
 
+// Envelope history + duck curve preview.
+//
+// Rendering is layered: the background, grid, labels and curve preview live
+// in a cached image that is only rebuilt when attack/hold/release/curve/duck
+// amount or the size change. The history is a circular buffer with one point
+// per pixel column, drawn incrementally into a scrolling image. Setters never
+// repaint; the owner calls flush() once per frame to issue a single repaint.
 class EnvelopeDisplay : public juce::Component
 {
 public:
     EnvelopeDisplay()
     {
         // Initialize envelope history
-        envelopeHistory.resize(historySize, 0.0f);
+        envelopeMinHistory.resize(maxHistorySize, 0.0f);
+        envelopeMaxHistory.resize(maxHistorySize, 0.0f);
     }
 
-    void setEnvelopeValue(float value)
+    void setSampleRate(double sampleRate)
     {
-        // Shift history and add new value
-        for (int i = historySize - 1; i > 0; --i)
-            envelopeHistory[i] = envelopeHistory[i - 1];
-        envelopeHistory[0] = value;
-        repaint();
+        if (sampleRate != currentSampleRate)
+        {
+            currentSampleRate = sampleRate;
+            updateSamplesPerPoint();
+        }
     }
 
-    void setAttackMs(float ms) { attackMs = ms; }
-    void setHoldMs(float ms) { holdMs = ms; }
-    void setReleaseMs(float ms) { releaseMs = ms; }
-    void setDuckAmount(float db) { duckAmountDb = db; }
-    void setCurveShape(int shape) { curveShape = static_cast<DSPUtils::CurveShape>(shape); }
-    void setTriggered(bool trig) { triggered = trig; }
+    // Fold a telemetry frame into the history. Frames are accumulated until
+    // they cover one history point, keeping the true min/max of the envelope.
+    void pushFrame(const TelemetryFrame& frame)
+    {
+        accumMin = juce::jmin(accumMin, frame.envelopeMin);
+        accumMax = juce::jmax(accumMax, frame.envelopeMax);
+        accumSamples += frame.numSamples;
+
+        if (accumSamples < samplesPerPoint)
+            return;
+
+        writeIndex = (writeIndex + 1) % maxHistorySize;
+        envelopeMinHistory[(size_t)writeIndex] = accumMin;
+        envelopeMaxHistory[(size_t)writeIndex] = accumMax;
+        pendingPoints = juce::jmin(pendingPoints + 1, maxHistorySize);
+
+        accumMin = 1.0f;
+        accumMax = 0.0f;
+        accumSamples = 0;
+    }
+
+    void setAttackMs(float ms) { setStaticValue(attackMs, ms); }
+    void setHoldMs(float ms) { setStaticValue(holdMs, ms); }
+    void setReleaseMs(float ms) { setStaticValue(releaseMs, ms); }
+    void setDuckAmount(float db) { setStaticValue(duckAmountDb, db); }
+
+    void setCurveShape(int shape)
+    {
+        auto newShape = static_cast<DSPUtils::CurveShape>(shape);
+        if (newShape != curveShape)
+        {
+            curveShape = newShape;
+            staticLayerDirty = true;
+        }
+    }
+
+    void setTriggered(bool trig)
+    {
+        if (trig != triggered)
+        {
+            triggered = trig;
+            triggerDirty = true;
+        }
+    }
+
+    // Draw any pending history columns and repaint the union of everything
+    // that changed since the last call.
+    void flush()
+    {
+        juce::Rectangle<int> dirty;
+
+        if (staticLayerDirty)
+            dirty = getLocalBounds();
+
+        if (pendingPoints > 0)
+        {
+            updateHistoryImage();
+            dirty = dirty.getUnion(getHistoryArea());
+        }
+
+        if (triggerDirty)
+        {
+            dirty = dirty.getUnion(getTriggerArea());
+            triggerDirty = false;
+        }
+
+        if (!dirty.isEmpty())
+            repaint(dirty);
+    }
 
     void paint(juce::Graphics& g) override
     {
+        auto scale = juce::jmax(1, juce::roundToInt(juce::Component::getApproximateScaleFactorForComponent(this)));
+        if (scale != imageScale)
+        {
+            imageScale = scale;
+            staticLayerDirty = true;
+            historyImage = {};
+        }
+
+        if (staticLayerDirty || !staticLayer.isValid())
+            renderStaticLayer();
+
+        if (!historyImage.isValid())
+            updateHistoryImage();
+
+        g.drawImage(staticLayer, getLocalBounds().toFloat());
+
+        if (historyImage.isValid())
+            g.drawImage(historyImage, getHistoryArea().toFloat());
+
+        // Trigger indicator
+        if (triggered)
+        {
+            g.setColour(Colors::led);
+            g.fillEllipse(getTriggerArea().toFloat());
+        }
+    }
+
+    void resized() override
+    {
+        staticLayerDirty = true;
+        historyImage = {};
+        updateSamplesPerPoint();
+    }
+
+private:
+    void setStaticValue(float& field, float value)
+    {
+        if (field != value)
+        {
+            field = value;
+            staticLayerDirty = true;
+        }
+    }
+
+    juce::Rectangle<int> getHistoryArea() const { return getLocalBounds().reduced(12); }
+
+    juce::Rectangle<int> getTriggerArea() const
+    {
+        auto bounds = getLocalBounds().reduced(2);
+        return { bounds.getRight() - 12, bounds.getY() + 4, 8, 8 };
+    }
+
+    int getNumColumns() const { return juce::jlimit(1, maxHistorySize, getHistoryArea().getWidth()); }
+
+    void updateSamplesPerPoint()
+    {
+        samplesPerPoint = juce::jmax(1, (int)(currentSampleRate * historySeconds / getNumColumns()));
+    }
+
+    void renderStaticLayer()
+    {
+        staticLayerDirty = false;
+
+        if (getWidth() <= 0 || getHeight() <= 0)
+            return;
+
+        staticLayer = juce::Image(juce::Image::ARGB, getWidth() * imageScale, getHeight() * imageScale, true);
+        juce::Graphics g(staticLayer);
+        g.addTransform(juce::AffineTransform::scale((float)imageScale));
+
         auto bounds = getLocalBounds().toFloat().reduced(2.0f);
 
         // Background
@@ -52,25 +194,14 @@ public:
         // Draw duck curve shape preview
         drawCurvePreview(g, bounds);
 
-        // Draw envelope history
-        drawEnvelopeHistory(g, bounds);
-
         // Draw labels
         g.setColour(Colors::textSecondary);
         g.setFont(10.0f);
         g.drawText("0 dB", bounds.getX() + 4, (int)bounds.getY() + 2, 40, 12, juce::Justification::left);
         g.drawText(juce::String(duckAmountDb, 0) + " dB", bounds.getX() + 4,
                    (int)bounds.getBottom() - 14, 50, 12, juce::Justification::left);
-
-        // Trigger indicator
-        if (triggered)
-        {
-            g.setColour(Colors::led);
-            g.fillEllipse(bounds.getRight() - 12, bounds.getY() + 4, 8, 8);
-        }
     }
 
-private:
     void drawCurvePreview(juce::Graphics& g, juce::Rectangle<float>& bounds)
     {
         // Calculate total time for the envelope display
@@ -124,46 +255,94 @@ private:
         g.strokePath(curvePath, juce::PathStrokeType(2.0f));
     }
 
-    void drawEnvelopeHistory(juce::Graphics& g, juce::Rectangle<float>& bounds)
+    // Scroll the history image by the number of pending points and draw only
+    // the new columns. Falls back to a full redraw after a resize.
+    void updateHistoryImage()
     {
-        float padding = 10.0f;
-        auto drawArea = bounds.reduced(padding);
+        auto area = getHistoryArea();
+        if (area.isEmpty())
+        {
+            pendingPoints = 0;
+            return;
+        }
 
-        juce::Path historyPath;
-        bool pathStarted = false;
+        int numColumns = getNumColumns();
+        int firstColumn = 0;
 
-        for (int i = 0; i < historySize; ++i)
+        if (!historyImage.isValid())
         {
-            float x = drawArea.getRight() - (i / (float)historySize) * drawArea.getWidth();
-            float y = drawArea.getY() + (1.0f - envelopeHistory[i]) * drawArea.getHeight();
-
-            if (!pathStarted)
-            {
-                historyPath.startNewSubPath(x, y);
-                pathStarted = true;
-            }
-            else
-            {
-                historyPath.lineTo(x, y);
-            }
+            historyImage = juce::Image(juce::Image::ARGB, numColumns * imageScale, area.getHeight() * imageScale, true);
         }
+        else if (pendingPoints < numColumns)
+        {
+            int shift = pendingPoints * imageScale;
+            historyImage.moveImageSection(0, 0, shift, 0, historyImage.getWidth() - shift, historyImage.getHeight());
+            firstColumn = numColumns - pendingPoints;
+            historyImage.clear({ firstColumn * imageScale, 0, shift, historyImage.getHeight() });
+        }
+        else
+        {
+            historyImage.clear(historyImage.getBounds());
+        }
+
+        pendingPoints = 0;
+
+        juce::Graphics g(historyImage);
+        g.addTransform(juce::AffineTransform::scale((float)imageScale));
+        g.reduceClipRegion(firstColumn, 0, numColumns - firstColumn, area.getHeight());
+
+        auto height = (float)area.getHeight();
+        auto pointIndexForColumn = [&](int column)
+        {
+            return (writeIndex - (numColumns - 1 - column) + maxHistorySize) % maxHistorySize;
+        };
+
+        float previousY = (1.0f - envelopeMaxHistory[(size_t)pointIndexForColumn(juce::jmax(0, firstColumn - 1))]) * height;
 
-        // Fill under the curve
-        juce::Path fillPath = historyPath;
-        fillPath.lineTo(drawArea.getX(), drawArea.getBottom());
-        fillPath.lineTo(drawArea.getRight(), drawArea.getBottom());
-        fillPath.closeSubPath();
+        for (int column = firstColumn; column < numColumns; ++column)
+        {
+            auto index = (size_t)pointIndexForColumn(column);
+            float yMax = (1.0f - envelopeMaxHistory[index]) * height;
+            float yMin = (1.0f - envelopeMinHistory[index]) * height;
+            float x = (float)column;
+
+            // Fill under the curve
+            g.setColour(Colors::duckPurple.withAlpha(0.15f));
+            g.fillRect(x, yMax, 1.0f, height - yMax);
+
+            // Min/max band
+            g.setColour(Colors::duckPurple.withAlpha(0.35f));
+            g.fillRect(x, yMax, 1.0f, juce::jmax(0.0f, yMin - yMax));
 
-        g.setColour(Colors::duckPurple.withAlpha(0.15f));
-        g.fillPath(fillPath);
+            // History line
+            g.setColour(Colors::duckPurple);
+            g.drawLine(x - 0.5f, previousY, x + 0.5f, yMax, 2.0f);
 
-        // Draw the history line
-        g.setColour(Colors::duckPurple);
-        g.strokePath(historyPath, juce::PathStrokeType(2.0f));
+            previousY = yMax;
+        }
     }
 
-    std::vector<float> envelopeHistory;
-    static constexpr int historySize = 128;
+    // History: circular buffer, one point per pixel column
+    std::vector<float> envelopeMinHistory;
+    std::vector<float> envelopeMaxHistory;
+    static constexpr int maxHistorySize = 2048;
+    static constexpr double historySeconds = 4.0;
+    int writeIndex = 0;
+    int pendingPoints = 0;
+
+    // Accumulator for the history point currently being built
+    double currentSampleRate = 44100.0;
+    int samplesPerPoint = 400;
+    int accumSamples = 0;
+    float accumMin = 1.0f;
+    float accumMax = 0.0f;
+
+    // Cached layers
+    juce::Image staticLayer;
+    juce::Image historyImage;
+    int imageScale = 1;
+    bool staticLayerDirty = true;
+    bool triggerDirty = false;
 
     float attackMs = 10.0f;
     float holdMs = 50.0f;
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include <map>
+#include <tuple>
 
 namespace Colors
 {
@@ -18,32 +20,50 @@ namespace Colors
     const juce::Colour duckPurple    = juce::Colour(0xff8b5cf6);
 }
 
-class DuckerLookAndFeel : public juce::LookAndFeel_V4
+// Pre-rendered knob bodies (outer ring, knurls, gradient body), keyed by size,
+// physical scale and enabled state. Shared by every editor in the process via
+// juce::SharedResourcePointer; only touched from the message thread.
+class KnobImageCache
 {
 public:
-    DuckerLookAndFeel()
+    const juce::Image& getBody(int width, int height, float scale, bool enabled)
     {
-        setColour(juce::Slider::thumbColourId, Colors::accent);
-        setColour(juce::Slider::rotarySliderFillColourId, Colors::accent);
-        setColour(juce::Slider::rotarySliderOutlineColourId, Colors::knobBody);
-        setColour(juce::Label::textColourId, Colors::textPrimary);
-        setColour(juce::ComboBox::backgroundColourId, Colors::panelBg);
-        setColour(juce::ComboBox::textColourId, Colors::textPrimary);
-        setColour(juce::ComboBox::outlineColourId, Colors::knobBody);
-        setColour(juce::PopupMenu::backgroundColourId, Colors::panelBg);
-        setColour(juce::PopupMenu::textColourId, Colors::textPrimary);
-        setColour(juce::PopupMenu::highlightedBackgroundColourId, Colors::accent);
-        setColour(juce::ToggleButton::textColourId, Colors::textPrimary);
-        setColour(juce::ToggleButton::tickColourId, Colors::accent);
+        JUCE_ASSERT_MESSAGE_THREAD
+
+        Key key { width, height, juce::roundToInt(scale * 100.0f), enabled };
+        auto it = bodies.find(key);
+        if (it != bodies.end())
+            return it->second;
+
+        // Sizes only change on resize/scale changes; keep the cache bounded
+        if (bodies.size() >= maxEntries)
+            bodies.clear();
+
+        return bodies.emplace(key, renderBody(width, height, scale, enabled)).first->second;
     }
 
-    void setAccentColour(juce::Colour c) { accentColour = c; }
+private:
+    struct Key
+    {
+        int width, height, scaleHundredths;
+        bool enabled;
 
-    void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
-                          float sliderPosProportional, float, float,
-                          juce::Slider&) override
+        bool operator<(const Key& other) const
+        {
+            return std::tie(width, height, scaleHundredths, enabled)
+                 < std::tie(other.width, other.height, other.scaleHundredths, other.enabled);
+        }
+    };
+
+    static juce::Image renderBody(int width, int height, float scale, bool enabled)
     {
-        auto bounds = juce::Rectangle<float>((float)x, (float)y, (float)width, (float)height).reduced(2.0f);
+        juce::Image image(juce::Image::ARGB,
+                          juce::jmax(1, juce::roundToInt(width * scale)),
+                          juce::jmax(1, juce::roundToInt(height * scale)), true);
+        juce::Graphics g(image);
+        g.addTransform(juce::AffineTransform::scale(scale));
+
+        auto bounds = juce::Rectangle<float>(0.0f, 0.0f, (float)width, (float)height).reduced(2.0f);
         float cx = bounds.getCentreX();
         float cy = bounds.getCentreY();
         float radius = juce::jmin(bounds.getWidth(), bounds.getHeight()) / 2.0f - 2.0f;
@@ -76,6 +96,57 @@ public:
         g.setColour(juce::Colour(0xff606060));
         g.drawEllipse(cx - innerRadius, cy - innerRadius, innerRadius * 2.0f, innerRadius * 2.0f, 1.0f);
 
+        if (!enabled)
+            image.multiplyAllAlphas(0.5f);
+
+        return image;
+    }
+
+    static constexpr size_t maxEntries = 64;
+    std::map<Key, juce::Image> bodies;
+};
+
+class DuckerLookAndFeel : public juce::LookAndFeel_V4
+{
+public:
+    DuckerLookAndFeel()
+    {
+        setColour(juce::Slider::thumbColourId, Colors::accent);
+        setColour(juce::Slider::rotarySliderFillColourId, Colors::accent);
+        setColour(juce::Slider::rotarySliderOutlineColourId, Colors::knobBody);
+        setColour(juce::Label::textColourId, Colors::textPrimary);
+        setColour(juce::ComboBox::backgroundColourId, Colors::panelBg);
+        setColour(juce::ComboBox::textColourId, Colors::textPrimary);
+        setColour(juce::ComboBox::outlineColourId, Colors::knobBody);
+        setColour(juce::PopupMenu::backgroundColourId, Colors::panelBg);
+        setColour(juce::PopupMenu::textColourId, Colors::textPrimary);
+        setColour(juce::PopupMenu::highlightedBackgroundColourId, Colors::accent);
+        setColour(juce::ToggleButton::textColourId, Colors::textPrimary);
+        setColour(juce::ToggleButton::tickColourId, Colors::accent);
+        setColour(juce::TextEditor::backgroundColourId, Colors::background);
+        setColour(juce::TextEditor::textColourId, Colors::textPrimary);
+        setColour(juce::TextEditor::outlineColourId, Colors::knobBody);
+        setColour(juce::TextEditor::focusedOutlineColourId, Colors::accent);
+    }
+
+    void setAccentColour(juce::Colour c) { accentColour = c; }
+
+    void drawRotarySlider(juce::Graphics& g, int x, int y, int width, int height,
+                          float sliderPosProportional, float, float,
+                          juce::Slider& slider) override
+    {
+        auto area = juce::Rectangle<float>((float)x, (float)y, (float)width, (float)height);
+        auto bounds = area.reduced(2.0f);
+        float cx = bounds.getCentreX();
+        float cy = bounds.getCentreY();
+        float radius = juce::jmin(bounds.getWidth(), bounds.getHeight()) / 2.0f - 2.0f;
+        float innerRadius = radius * 0.78f;
+        bool enabled = slider.isEnabled();
+
+        // Static body comes from the process-wide cache
+        auto scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+        g.drawImage(knobCache->getBody(width, height, scale, enabled), area);
+
         // Indicator line (7 o'clock to 5 o'clock range)
         float indicatorAngle = juce::jmap(sliderPosProportional, 0.0f, 1.0f, -1.047f, 4.189f) + juce::MathConstants<float>::pi;
         float indicatorLength = innerRadius * 0.65f;
@@ -83,7 +154,7 @@ public:
         float iy1 = cy + (innerRadius * 0.2f) * std::sin(indicatorAngle);
         float ix2 = cx + indicatorLength * std::cos(indicatorAngle);
         float iy2 = cy + indicatorLength * std::sin(indicatorAngle);
-        g.setColour(accentColour);
+        g.setColour(enabled ? accentColour : accentColour.withMultipliedAlpha(0.5f));
         g.drawLine(ix1, iy1, ix2, iy2, 3.0f);
 
         // Center cap
@@ -120,4 +191,5 @@ public:
 
 private:
     juce::Colour accentColour = Colors::accent;
+    juce::SharedResourcePointer<KnobImageCache> knobCache;
 };
@@ -3,12 +3,62 @@
 #include <JuceHeader.h>
 #include "LookAndFeel.h"
 
+// Frame-rate independent meter smoothing. Coefficients are derived from the
+// elapsed time so meters behave the same at 30, 60 or 120 Hz.
+class MeterBallistics
+{
+public:
+    float process(float target, double elapsedSeconds)
+    {
+        auto dt = (float)juce::jlimit(0.0, 0.25, elapsedSeconds);
+
+        value += (1.0f - std::exp(-dt / smoothingSeconds)) * (target - value);
+
+        // Faster decay when signal drops
+        if (target < value)
+            value *= std::exp(-dt / decaySeconds);
+
+        return value;
+    }
+
+    float getValue() const { return value; }
+
+private:
+    static constexpr float smoothingSeconds = 0.15f;
+    static constexpr float decaySeconds = 0.4f;
+
+    float value = 0.0f;
+};
+
+// Invalidate only the strip between two bar extents (plus the rounded corner)
+// rather than the whole meter.
+inline juce::Rectangle<int> getMeterDirtyRegion(juce::Rectangle<int> bounds, bool vertical,
+                                                bool fromEnd, int oldExtent, int newExtent)
+{
+    const int cornerPadding = 3;
+    int lo = juce::jmin(oldExtent, newExtent) - cornerPadding;
+    int hi = juce::jmax(oldExtent, newExtent) + cornerPadding;
+
+    if (vertical)
+    {
+        int y0 = fromEnd ? bounds.getBottom() - hi : bounds.getY() + lo;
+        return juce::Rectangle<int>(bounds.getX(), y0, bounds.getWidth(), hi - lo).getIntersection(bounds);
+    }
+
+    return juce::Rectangle<int>(bounds.getX() + lo, bounds.getY(), hi - lo, bounds.getHeight()).getIntersection(bounds);
+}
+
 class LevelMeter : public juce::Component
 {
 public:
     LevelMeter(bool isVertical = true) : vertical(isVertical) {}
 
-    void setLevel(float newLevel) { level = newLevel; repaint(); }
+    // Repaints only when the quantized bar position or colour zone changes
+    void setLevel(float newLevel)
+    {
+        level = newLevel;
+        updateBar();
+    }
 
     void paint(juce::Graphics& g) override
     {
@@ -18,16 +68,11 @@ public:
         g.setColour(juce::Colour(0xff151515));
         g.fillRoundedRectangle(bounds, 3.0f);
 
-        // Convert to dB and normalize
-        float db = juce::Decibels::gainToDecibels(level, -60.0f);
-        float normalized = juce::jmap(db, -60.0f, 0.0f, 0.0f, 1.0f);
-        normalized = juce::jlimit(0.0f, 1.0f, normalized);
-
         // Level bar with color zones
         juce::Colour barColour;
-        if (normalized < 0.6f)
+        if (zone == 0)
             barColour = Colors::meterGreen;
-        else if (normalized < 0.85f)
+        else if (zone == 1)
             barColour = Colors::meterYellow;
         else
             barColour = Colors::meterRed;
@@ -36,20 +81,53 @@ public:
 
         if (vertical)
         {
-            float barHeight = bounds.getHeight() * normalized;
+            float barHeight = (float)barPixels;
             g.fillRoundedRectangle(bounds.getX(), bounds.getBottom() - barHeight,
                                     bounds.getWidth(), barHeight, 2.0f);
         }
         else
         {
-            float barWidth = bounds.getWidth() * normalized;
+            float barWidth = (float)barPixels;
             g.fillRoundedRectangle(bounds.getX(), bounds.getY(),
                                     barWidth, bounds.getHeight(), 2.0f);
         }
     }
 
+    void resized() override
+    {
+        barPixels = -1;
+        updateBar();
+    }
+
 private:
+    void updateBar()
+    {
+        // Convert to dB and normalize
+        float db = juce::Decibels::gainToDecibels(level, -60.0f);
+        float normalized = juce::jmap(db, -60.0f, 0.0f, 0.0f, 1.0f);
+        normalized = juce::jlimit(0.0f, 1.0f, normalized);
+
+        int newZone = normalized < 0.6f ? 0 : (normalized < 0.85f ? 1 : 2);
+
+        auto barArea = getLocalBounds().reduced(1);
+        int length = vertical ? barArea.getHeight() : barArea.getWidth();
+        int newPixels = juce::roundToInt(length * normalized);
+
+        if (newPixels == barPixels && newZone == zone)
+            return;
+
+        if (newZone != zone || barPixels < 0)
+            repaint();
+        else
+            repaint(getMeterDirtyRegion(barArea, vertical, true, barPixels, newPixels));
+
+        barPixels = newPixels;
+        zone = newZone;
+    }
+
     float level = 0.0f;
+    int barPixels = -1;
+    int zone = 0;
     bool vertical;
 };
 
@@ -58,7 +136,12 @@ class GainReductionMeter : public juce::Component
 public:
     GainReductionMeter(bool isVertical = true) : vertical(isVertical) {}
 
-    void setGainReduction(float gr) { gainReduction = gr; repaint(); }
+    // Repaints only when the quantized bar position changes
+    void setGainReduction(float gr)
+    {
+        gainReduction = gr;
+        updateBar();
+    }
 
     void paint(juce::Graphics& g) override
     {
@@ -68,29 +151,53 @@ public:
         g.setColour(juce::Colour(0xff151515));
         g.fillRoundedRectangle(bounds, 3.0f);
 
-        // Normalize GR (0-20 dB range)
-        float normalized = juce::jmap(gainReduction, 0.0f, 20.0f, 0.0f, 1.0f);
-        normalized = juce::jlimit(0.0f, 1.0f, normalized);
-
         // GR meter typically shows in orange/amber
         g.setColour(Colors::meterYellow);
 
         if (vertical)
         {
             // GR meter shows from top down
-            float barHeight = bounds.getHeight() * normalized;
+            float barHeight = (float)barPixels;
             g.fillRoundedRectangle(bounds.getX(), bounds.getY(),
                                     bounds.getWidth(), barHeight, 2.0f);
         }
         else
         {
-            float barWidth = bounds.getWidth() * normalized;
+            float barWidth = (float)barPixels;
             g.fillRoundedRectangle(bounds.getX(), bounds.getY(),
                                     barWidth, bounds.getHeight(), 2.0f);
         }
     }
 
+    void resized() override
+    {
+        barPixels = -1;
+        updateBar();
+    }
+
 private:
+    void updateBar()
+    {
+        // Normalize GR (0-20 dB range)
+        float normalized = juce::jmap(gainReduction, 0.0f, 20.0f, 0.0f, 1.0f);
+        normalized = juce::jlimit(0.0f, 1.0f, normalized);
+
+        auto barArea = getLocalBounds().reduced(1);
+        int length = vertical ? barArea.getHeight() : barArea.getWidth();
+        int newPixels = juce::roundToInt(length * normalized);
+
+        if (newPixels == barPixels)
+            return;
+
+        if (barPixels < 0)
+            repaint();
+        else
+            repaint(getMeterDirtyRegion(barArea, vertical, false, barPixels, newPixels));
+
+        barPixels = newPixels;
+    }
+
     float gainReduction = 0.0f;
+    int barPixels = -1;
     bool vertical;
 };
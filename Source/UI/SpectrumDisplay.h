@@ -0,0 +1,162 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "LookAndFeel.h"
+#include "../DSP/DSPUtils.h"
+#include "../Analysis/SpectrumAnalyser.h"
+
+// Sidechain spectrum with the SC HPF/LPF magnitude response drawn over it.
+// The spectrum comes from SpectrumAnalyser's background thread; the filter
+// response is only re-evaluated when the filter settings change.
+class SpectrumDisplay : public juce::Component
+{
+public:
+    SpectrumDisplay()
+    {
+        spectrum.fill(SpectrumAnalyser::floorDb);
+        response.fill(0.0f);
+    }
+
+    // Pull the newest spectrum from the analyser; repaints if one arrived
+    void update(SpectrumAnalyser& analyser)
+    {
+        if (analyser.getLatestSpectrum(spectrum))
+            repaint();
+    }
+
+    void setFilters(double sampleRate, float hpfFreq, bool hpfOn, float lpfFreq, bool lpfOn)
+    {
+        if (sampleRate == filterSampleRate && hpfFreq == hpfFrequency && hpfOn == hpfEnabled
+            && lpfFreq == lpfFrequency && lpfOn == lpfEnabled)
+            return;
+
+        if (sampleRate != filterSampleRate)
+            updateFrequencyTables(sampleRate);
+
+        filterSampleRate = sampleRate;
+        hpfFrequency = hpfFreq;
+        hpfEnabled = hpfOn;
+        lpfFrequency = lpfFreq;
+        lpfEnabled = lpfOn;
+
+        response.fill(0.0f);
+        if (hpfEnabled)
+            addBiquadResponse(DSPUtils::calcHighPass(sampleRate, hpfFrequency, 0.707f));
+        if (lpfEnabled)
+            addBiquadResponse(DSPUtils::calcLowPass(sampleRate, lpfFrequency, 0.707f));
+
+        repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat().reduced(2.0f);
+
+        // Background
+        g.setColour(juce::Colour(0xff151515));
+        g.fillRoundedRectangle(bounds, 4.0f);
+
+        g.setColour(juce::Colour(0xff303030));
+        g.drawRoundedRectangle(bounds, 4.0f, 1.0f);
+
+        auto area = bounds.reduced(4.0f);
+
+        // Decade grid lines
+        g.setColour(juce::Colour(0xff252525));
+        for (float f : { 100.0f, 1000.0f, 10000.0f })
+            g.drawVerticalLine((int)frequencyToX(f, area), area.getY(), area.getBottom());
+
+        // Spectrum
+        juce::Path spectrumPath;
+        spectrumPath.startNewSubPath(area.getX(), area.getBottom());
+        for (int i = 0; i < SpectrumAnalyser::numPoints; ++i)
+            spectrumPath.lineTo(pointToX(i, area), dbToY(spectrum[(size_t)i], area));
+        spectrumPath.lineTo(area.getRight(), area.getBottom());
+        spectrumPath.closeSubPath();
+
+        g.setColour(Colors::meterYellow.withAlpha(0.35f));
+        g.fillPath(spectrumPath);
+
+        // Filter response (0 dB at the top of the range)
+        if (hpfEnabled || lpfEnabled)
+        {
+            juce::Path responsePath;
+            for (int i = 0; i < SpectrumAnalyser::numPoints; ++i)
+            {
+                auto y = dbToY(response[(size_t)i] + responseTopDb, area);
+                if (i == 0)
+                    responsePath.startNewSubPath(pointToX(i, area), y);
+                else
+                    responsePath.lineTo(pointToX(i, area), y);
+            }
+
+            g.setColour(Colors::accent);
+            g.strokePath(responsePath, juce::PathStrokeType(1.5f));
+        }
+
+        g.setColour(Colors::textSecondary);
+        g.setFont(10.0f);
+        g.drawText("SC SPECTRUM", area.toNearestInt().removeFromTop(12), juce::Justification::left);
+    }
+
+private:
+    static constexpr float topDb = 0.0f;
+    static constexpr float bottomDb = -90.0f;
+    static constexpr float responseTopDb = -6.0f;
+    static constexpr int numPoints = SpectrumAnalyser::numPoints;
+
+    static float pointToX(int index, juce::Rectangle<float> area)
+    {
+        return area.getX() + area.getWidth() * index / (float)(numPoints - 1);
+    }
+
+    static float frequencyToX(float freq, juce::Rectangle<float> area)
+    {
+        auto proportion = std::log(freq / SpectrumAnalyser::minFrequency)
+                        / std::log(SpectrumAnalyser::maxFrequency / SpectrumAnalyser::minFrequency);
+        return area.getX() + area.getWidth() * proportion;
+    }
+
+    static float dbToY(float db, juce::Rectangle<float> area)
+    {
+        return juce::jmap(juce::jlimit(bottomDb, topDb, db), topDb, bottomDb, area.getY(), area.getBottom());
+    }
+
+    void updateFrequencyTables(double sampleRate)
+    {
+        for (int i = 0; i < numPoints; ++i)
+        {
+            auto w = juce::MathConstants<float>::twoPi * SpectrumAnalyser::getFrequencyForPoint(i) / (float)sampleRate;
+            cosW[(size_t)i] = std::cos(w);
+            cos2W[(size_t)i] = std::cos(2.0f * w);
+        }
+    }
+
+    // |H(e^jw)|^2 = (B0 + B1 cos w + B2 cos 2w) / (A0 + A1 cos w + A2 cos 2w)
+    // evaluated across all points with vector ops, accumulated in dB
+    void addBiquadResponse(const DSPUtils::BiquadCoeffs& c)
+    {
+        auto* num = numerator.data();
+        auto* den = denominator.data();
+
+        juce::FloatVectorOperations::copyWithMultiply(num, cosW.data(), 2.0f * (c.b0 * c.b1 + c.b1 * c.b2), numPoints);
+        juce::FloatVectorOperations::addWithMultiply(num, cos2W.data(), 2.0f * c.b0 * c.b2, numPoints);
+        juce::FloatVectorOperations::add(num, c.b0 * c.b0 + c.b1 * c.b1 + c.b2 * c.b2, numPoints);
+
+        juce::FloatVectorOperations::copyWithMultiply(den, cosW.data(), 2.0f * (c.a1 + c.a1 * c.a2), numPoints);
+        juce::FloatVectorOperations::addWithMultiply(den, cos2W.data(), 2.0f * c.a2, numPoints);
+        juce::FloatVectorOperations::add(den, 1.0f + c.a1 * c.a1 + c.a2 * c.a2, numPoints);
+
+        for (int i = 0; i < numPoints; ++i)
+            response[(size_t)i] += 10.0f * std::log10(juce::jmax(1.0e-12f, num[i]) / juce::jmax(1.0e-12f, den[i]));
+    }
+
+    std::array<float, numPoints> spectrum {};
+    std::array<float, numPoints> response {};
+    std::array<float, numPoints> cosW {}, cos2W {};
+    std::array<float, numPoints> numerator {}, denominator {};
+
+    double filterSampleRate = 0.0;
+    float hpfFrequency = 0.0f, lpfFrequency = 0.0f;
+    bool hpfEnabled = false, lpfEnabled = false;
+};
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "LookAndFeel.h"
+#include "../DSP/Telemetry.h"
+
+// Multi-level min/max decimation pyramid over telemetry frames.
+// Level 0 holds one entry per frame; each level above merges pairs from the
+// level below, so any zoom can be drawn from the level whose bucket size is
+// closest to the samples-per-pixel ratio - O(pixels), not O(samples).
+class MinMaxPyramid
+{
+public:
+    struct Entry
+    {
+        float keyMin = 0.0f, keyMax = 0.0f;
+        float mainMin = 0.0f, mainMax = 0.0f;
+        float gainMin = 1.0f, gainMax = 1.0f;
+
+        void merge(const Entry& other)
+        {
+            keyMin = juce::jmin(keyMin, other.keyMin);
+            keyMax = juce::jmax(keyMax, other.keyMax);
+            mainMin = juce::jmin(mainMin, other.mainMin);
+            mainMax = juce::jmax(mainMax, other.mainMax);
+            gainMin = juce::jmin(gainMin, other.gainMin);
+            gainMax = juce::jmax(gainMax, other.gainMax);
+        }
+    };
+
+    // Level 0 capacity is rounded up to a power of two
+    void reset(int level0Capacity)
+    {
+        int capacity = juce::nextPowerOfTwo(juce::jmax(minLevelCapacity, level0Capacity));
+
+        levels.clear();
+        while (capacity >= minLevelCapacity)
+        {
+            Level level;
+            level.entries.resize((size_t)capacity);
+            level.mask = capacity - 1;
+            levels.push_back(std::move(level));
+            capacity /= 2;
+        }
+    }
+
+    void append(const Entry& entry)
+    {
+        Entry carry = entry;
+
+        for (size_t k = 0; k < levels.size(); ++k)
+        {
+            auto& level = levels[k];
+            level.entries[(size_t)(level.written & level.mask)] = carry;
+            ++level.written;
+
+            // Only every second entry completes a bucket in the level above
+            if ((level.written & 1) != 0 || k + 1 == levels.size())
+                break;
+
+            carry = level.entries[(size_t)((level.written - 2) & level.mask)];
+            carry.merge(level.entries[(size_t)((level.written - 1) & level.mask)]);
+        }
+    }
+
+    int getNumLevels() const { return (int)levels.size(); }
+
+    // Total entries ever written at level 0 (i.e. frames)
+    juce::int64 getNumFrames() const { return levels.empty() ? 0 : levels[0].written; }
+
+    juce::int64 getCapacityInFrames() const { return levels.empty() ? 0 : (juce::int64)levels[0].entries.size(); }
+
+    // Merge every stored entry covering frames [startFrame, endFrame) using
+    // the given level. Returns false if the range is no longer (or not yet) held.
+    bool query(int levelIndex, juce::int64 startFrame, juce::int64 endFrame, Entry& result) const
+    {
+        const auto& level = levels[(size_t)levelIndex];
+        auto first = startFrame >> levelIndex;
+        auto last = juce::jmax(first + 1, (endFrame + (1 << levelIndex) - 1) >> levelIndex);
+
+        first = juce::jmax(first, level.written - (juce::int64)level.entries.size());
+        last = juce::jmin(last, level.written);
+
+        if (first >= last)
+            return false;
+
+        result = level.entries[(size_t)(first & level.mask)];
+        for (auto i = first + 1; i < last; ++i)
+            result.merge(level.entries[(size_t)(i & level.mask)]);
+
+        return true;
+    }
+
+private:
+    struct Level
+    {
+        std::vector<Entry> entries;
+        juce::int64 mask = 0;
+        juce::int64 written = 0;
+    };
+
+    static constexpr int minLevelCapacity = 64;
+    std::vector<Level> levels;
+};
+
+// Scrolling overview of the key signal, the main signal and the applied gain
+// curve over the last few seconds. Fed from the editor's telemetry drain;
+// mouse-wheel zooms between 0.25 s and the full history.
+class WaveformOverview : public juce::Component
+{
+public:
+    WaveformOverview()
+    {
+        setSampleRate(44100.0);
+    }
+
+    void setSampleRate(double sampleRate)
+    {
+        if (sampleRate == currentSampleRate || sampleRate <= 0.0)
+            return;
+
+        currentSampleRate = sampleRate;
+        pyramid.reset((int)(sampleRate * maxHistorySeconds / samplesPerFrame));
+    }
+
+    void pushFrame(const TelemetryFrame& frame)
+    {
+        MinMaxPyramid::Entry entry;
+        entry.keyMin = frame.keyMin;
+        entry.keyMax = frame.keyMax;
+        entry.mainMin = frame.mainMin;
+        entry.mainMax = frame.mainMax;
+        entry.gainMin = frame.gainMin;
+        entry.gainMax = frame.gainMax;
+        pyramid.append(entry);
+        samplesPerFrame = juce::jmax(1, frame.numSamples);
+        hasNewData = true;
+    }
+
+    // Repaint once per frame, only if something arrived
+    void flush()
+    {
+        if (hasNewData)
+        {
+            hasNewData = false;
+            repaint();
+        }
+    }
+
+    void mouseWheelMove(const juce::MouseEvent&, const juce::MouseWheelDetails& wheel) override
+    {
+        auto maxSeconds = (double)pyramid.getCapacityInFrames() * samplesPerFrame / currentSampleRate;
+        visibleSeconds = juce::jlimit(0.25, juce::jmax(0.25, maxSeconds),
+                                      visibleSeconds * std::pow(2.0, -wheel.deltaY * 2.0));
+        repaint();
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto bounds = getLocalBounds().toFloat().reduced(2.0f);
+
+        // Background
+        g.setColour(juce::Colour(0xff151515));
+        g.fillRoundedRectangle(bounds, 4.0f);
+
+        g.setColour(juce::Colour(0xff303030));
+        g.drawRoundedRectangle(bounds, 4.0f, 1.0f);
+
+        auto area = bounds.reduced(6.0f).toNearestInt();
+        auto keyLane = area.removeFromTop(area.getHeight() / 2);
+        auto mainLane = area;
+
+        g.setColour(juce::Colour(0xff252525));
+        g.drawHorizontalLine(keyLane.getCentreY(), (float)keyLane.getX(), (float)keyLane.getRight());
+        g.drawHorizontalLine(mainLane.getCentreY(), (float)mainLane.getX(), (float)mainLane.getRight());
+
+        drawLanes(g, keyLane, mainLane);
+
+        // Labels
+        g.setColour(Colors::textSecondary);
+        g.setFont(10.0f);
+        g.drawText("KEY", keyLane.getX() + 2, keyLane.getY(), 40, 12, juce::Justification::left);
+        g.drawText("MAIN / GAIN", mainLane.getX() + 2, mainLane.getY(), 80, 12, juce::Justification::left);
+        g.drawText(juce::String(visibleSeconds, 2) + " s", keyLane.getRight() - 50, keyLane.getY(), 50, 12,
+                   juce::Justification::right);
+    }
+
+private:
+    void drawLanes(juce::Graphics& g, juce::Rectangle<int> keyLane, juce::Rectangle<int> mainLane)
+    {
+        int width = keyLane.getWidth();
+        auto endFrame = pyramid.getNumFrames();
+        if (width <= 0 || endFrame == 0)
+            return;
+
+        // Pick the coarsest level whose bucket still fits inside one pixel
+        double framesPerPixel = visibleSeconds * currentSampleRate / samplesPerFrame / width;
+        int levelIndex = 0;
+        while (levelIndex + 1 < pyramid.getNumLevels() && (double)(1 << (levelIndex + 1)) <= framesPerPixel)
+            ++levelIndex;
+
+        auto keyHalf = keyLane.getHeight() * 0.5f;
+        auto mainHalf = mainLane.getHeight() * 0.5f;
+        auto keyMid = (float)keyLane.getCentreY();
+        auto mainMid = (float)mainLane.getCentreY();
+
+        juce::Path gainPath;
+        bool gainStarted = false;
+
+        for (int x = 0; x < width; ++x)
+        {
+            auto start = endFrame - (juce::int64)std::ceil((width - x) * framesPerPixel);
+            auto end = endFrame - (juce::int64)std::ceil((width - x - 1) * framesPerPixel);
+
+            MinMaxPyramid::Entry e;
+            if (start < 0 || !pyramid.query(levelIndex, start, end, e))
+                continue;
+
+            auto px = (float)(keyLane.getX() + x);
+
+            g.setColour(Colors::meterYellow.withAlpha(0.8f));
+            auto kTop = keyMid - juce::jlimit(-1.0f, 1.0f, e.keyMax) * keyHalf;
+            auto kBottom = keyMid - juce::jlimit(-1.0f, 1.0f, e.keyMin) * keyHalf;
+            g.fillRect(px, kTop, 1.0f, juce::jmax(1.0f, kBottom - kTop));
+
+            g.setColour(Colors::duckBlue.withAlpha(0.8f));
+            auto mTop = mainMid - juce::jlimit(-1.0f, 1.0f, e.mainMax) * mainHalf;
+            auto mBottom = mainMid - juce::jlimit(-1.0f, 1.0f, e.mainMin) * mainHalf;
+            g.fillRect(px, mTop, 1.0f, juce::jmax(1.0f, mBottom - mTop));
+
+            // Gain curve across the main lane (top = unity)
+            auto gy = (float)mainLane.getY() + (1.0f - e.gainMin) * (float)mainLane.getHeight();
+            if (!gainStarted)
+            {
+                gainPath.startNewSubPath(px, gy);
+                gainStarted = true;
+            }
+            else
+            {
+                gainPath.lineTo(px, gy);
+            }
+        }
+
+        g.setColour(Colors::duckPurple);
+        g.strokePath(gainPath, juce::PathStrokeType(1.5f));
+    }
+
+    static constexpr double maxHistorySeconds = 16.0;
+
+    MinMaxPyramid pyramid;
+    double currentSampleRate = 0.0;
+    double visibleSeconds = 4.0;
+    int samplesPerFrame = 64;
+    bool hasNewData = false;
+};
@@ -0,0 +1,382 @@
+// ducker_bench - microbenchmarks for the DSP classes.
+//
+// Measures Ducker::process across block sizes, sample rates, channel counts
+// and feature flags, plus the per-sample building blocks it is made of, and
+// reports ns/sample and the share of the realtime budget used (100% = one
+// core fully busy keeping up with the sample rate).
+//
+// The test signal alternates bursts and gaps so the envelope cycles through
+// attack, hold, release and idle rather than sitting in one state.
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <iostream>
+#include "DSP/Ducker.h"
+
+namespace
+{
+    volatile float sink = 0.0f;
+
+    struct Options
+    {
+        double secondsPerCase = 0.2;
+        int repeats = 5;
+        bool full = false;
+        bool csv = false;
+        juce::String filter;
+    };
+
+    struct Config
+    {
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        int numChannels = 2;
+        bool zeroCrossing = false;
+        bool listen = false;
+        bool hpf = false;
+        bool lpf = false;
+        int curveShape = 0;
+
+        juce::String getFeatureName() const
+        {
+            juce::StringArray f;
+            if (zeroCrossing) f.add("zc");
+            if (listen)       f.add("listen");
+            if (hpf)          f.add("hpf");
+            if (lpf)          f.add("lpf");
+            if (curveShape)   f.add("curve" + juce::String(curveShape));
+            return f.isEmpty() ? "default" : f.joinIntoString("+");
+        }
+    };
+
+    // Deterministic bursts of noise: 120 ms on at -6 dBFS, 80 ms at -50 dBFS
+    void fillTestSignal(juce::AudioBuffer<float>& buffer, double sampleRate)
+    {
+        juce::Random random(1234);
+        auto period = (int)(0.2 * sampleRate);
+        auto onLength = (int)(0.12 * sampleRate);
+
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+        {
+            auto* data = buffer.getWritePointer(ch);
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+            {
+                auto level = (i % period) < onLength ? 0.5f : 0.003f;
+                data[i] = (random.nextFloat() * 2.0f - 1.0f) * level;
+            }
+        }
+    }
+
+    struct Measurement
+    {
+        double nsPerSample = 0.0;
+        double budgetPercent = 0.0;
+    };
+
+    // Runs fn(numSamples) repeatedly for about secondsPerCase, `repeats`
+    // times, and reports the median
+    template <typename Fn>
+    Measurement measure(const Options& options, double sampleRate, int samplesPerCall, Fn&& fn)
+    {
+        // Warm up and size the loop
+        auto calls = 1;
+        for (;;)
+        {
+            auto start = juce::Time::getHighResolutionTicks();
+            for (int c = 0; c < calls; ++c)
+                fn();
+            auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            if (seconds >= options.secondsPerCase * 0.25 || calls >= (1 << 24))
+            {
+                calls = juce::jmax(1, (int)(calls * options.secondsPerCase / juce::jmax(1.0e-9, seconds)));
+                break;
+            }
+            calls *= 2;
+        }
+
+        std::vector<double> runs;
+        for (int r = 0; r < options.repeats; ++r)
+        {
+            auto start = juce::Time::getHighResolutionTicks();
+            for (int c = 0; c < calls; ++c)
+                fn();
+            auto seconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+            runs.push_back(seconds * 1.0e9 / ((double)calls * samplesPerCall));
+        }
+
+        std::sort(runs.begin(), runs.end());
+
+        Measurement m;
+        m.nsPerSample = runs[runs.size() / 2];
+        m.budgetPercent = m.nsPerSample * sampleRate * 1.0e-9 * 100.0;
+        return m;
+    }
+
+    void report(const Options& options, const juce::String& name, const juce::String& detail, const Measurement& m)
+    {
+        if (options.csv)
+            std::cout << name << "," << detail << "," << juce::String(m.nsPerSample, 3) << ","
+                      << juce::String(m.budgetPercent, 4) << std::endl;
+        else
+            std::cout << juce::String::formatted("%-28s %-44s %9.2f ns/sample %9.4f %% budget",
+                                                 name.toRawUTF8(), detail.toRawUTF8(), m.nsPerSample, m.budgetPercent)
+                      << std::endl;
+    }
+
+    bool wanted(const Options& options, const juce::String& name)
+    {
+        return options.filter.isEmpty() || name.containsIgnoreCase(options.filter);
+    }
+
+    //==============================================================================
+    void benchDucker(const Options& options, const Config& config)
+    {
+        // Per-sample cost is per frame (all channels), so budget compares
+        // against one sample period
+        const int sourceLength = 1 << 16;
+        juce::AudioBuffer<float> source(config.numChannels, sourceLength);
+        juce::AudioBuffer<float> sidechain(2, sourceLength);
+        fillTestSignal(source, config.sampleRate);
+        fillTestSignal(sidechain, config.sampleRate);
+
+        Ducker ducker;
+        ducker.setZeroCrossingEnabled(config.zeroCrossing);
+        ducker.setSidechainListen(config.listen);
+        ducker.setSidechainHPFEnabled(config.hpf);
+        ducker.setSidechainLPFEnabled(config.lpf);
+        ducker.setCurveShape(config.curveShape);
+        ducker.prepare(config.sampleRate, config.blockSize);
+        ducker.setSidechainHPF(120.0f);
+        ducker.setSidechainLPF(8000.0f);
+
+        juce::AudioBuffer<float> main(config.numChannels, config.blockSize);
+        juce::AudioBuffer<float> sc(2, config.blockSize);
+        int position = 0;
+
+        auto m = measure(options, config.sampleRate, config.blockSize, [&]
+        {
+            if (position + config.blockSize > sourceLength)
+                position = 0;
+
+            // Fresh input each block (a memcpy, small next to the DSP)
+            for (int ch = 0; ch < config.numChannels; ++ch)
+                main.copyFrom(ch, 0, source, ch, position, config.blockSize);
+            for (int ch = 0; ch < 2; ++ch)
+                sc.copyFrom(ch, 0, sidechain, ch, position, config.blockSize);
+
+            ducker.process(main, sc);
+            position += config.blockSize;
+
+            // Keep the telemetry FIFO from filling up, as the editor would
+            ducker.getTelemetry().drain([](const TelemetryFrame&) {});
+            sink = sink + main.getSample(0, 0);
+        });
+
+        report(options, "Ducker::process",
+               juce::String::formatted("%6.1f kHz  block %4d  %dch  ", config.sampleRate / 1000.0, config.blockSize,
+                                       config.numChannels) + config.getFeatureName(),
+               m);
+    }
+
+    void benchComponents(const Options& options)
+    {
+        const double sampleRate = 48000.0;
+        const int blockSize = 512;
+        juce::AudioBuffer<float> signal(2, blockSize);
+        fillTestSignal(signal, sampleRate);
+        const auto* in = signal.getReadPointer(0);
+
+        if (wanted(options, "EnvelopeGenerator"))
+        {
+            EnvelopeGenerator envelope;
+            envelope.prepare(sampleRate, blockSize);
+
+            for (int shape = 0; shape < 4; ++shape)
+            {
+                envelope.setCurveShape(static_cast<DSPUtils::CurveShape>(shape));
+                auto m = measure(options, sampleRate, blockSize, [&]
+                {
+                    float acc = 0.0f;
+                    for (int i = 0; i < blockSize; ++i)
+                        acc += envelope.processSample(in[i]);
+                    sink = acc;
+                });
+                report(options, "EnvelopeGenerator::processSample", "curve" + juce::String(shape), m);
+            }
+        }
+
+        if (wanted(options, "SidechainProcessor"))
+        {
+            for (int filters = 0; filters < 4; ++filters)
+            {
+                SidechainProcessor processor;
+                processor.prepare(sampleRate, blockSize);
+                processor.setHighPassEnabled((filters & 1) != 0);
+                processor.setLowPassEnabled((filters & 2) != 0);
+                processor.setHighPassFreq(120.0f);
+                processor.setLowPassFreq(8000.0f);
+
+                juce::String detail = filters == 0 ? "bypass" : filters == 1 ? "hpf" : filters == 2 ? "lpf" : "hpf+lpf";
+
+                auto m = measure(options, sampleRate, blockSize, [&]
+                {
+                    float acc = 0.0f;
+                    for (int i = 0; i < blockSize; ++i)
+                        acc += processor.processSample(in[i]);
+                    sink = acc;
+                });
+                report(options, "SidechainProcessor::processSample", detail, m);
+
+                juce::AudioBuffer<float> work(2, blockSize);
+                auto mb = measure(options, sampleRate, blockSize, [&]
+                {
+                    work.makeCopyOf(signal, true);
+                    processor.processBuffer(work);
+                    sink = work.getSample(1, blockSize - 1);
+                });
+                report(options, "SidechainProcessor::processBuffer", detail + " stereo", mb);
+            }
+        }
+
+        if (wanted(options, "DSPUtils"))
+        {
+            auto m1 = measure(options, sampleRate, blockSize, [&]
+            {
+                float acc = 0.0f;
+                for (int i = 0; i < blockSize; ++i)
+                    acc += DSPUtils::linearToDecibels(std::abs(in[i]));
+                sink = acc;
+            });
+            report(options, "DSPUtils::linearToDecibels", "", m1);
+
+            auto m2 = measure(options, sampleRate, blockSize, [&]
+            {
+                float acc = 0.0f;
+                for (int i = 0; i < blockSize; ++i)
+                    acc += DSPUtils::decibelsToLinear(in[i] * 60.0f);
+                sink = acc;
+            });
+            report(options, "DSPUtils::decibelsToLinear", "", m2);
+
+            for (int shape = 0; shape < 4; ++shape)
+            {
+                auto curve = static_cast<DSPUtils::CurveShape>(shape);
+                auto m = measure(options, sampleRate, blockSize, [&]
+                {
+                    float acc = 0.0f;
+                    for (int i = 0; i < blockSize; ++i)
+                        acc += DSPUtils::applyCurveShape(std::abs(in[i]), curve);
+                    sink = acc;
+                });
+                report(options, "DSPUtils::applyCurveShape", "curve" + juce::String(shape), m);
+            }
+        }
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: ducker_bench [options]\n"
+            << "\n"
+            << "Options:\n"
+            << "  --full              Full cartesian sweep instead of one axis at a time\n"
+            << "  --filter TEXT       Only run benchmarks whose name contains TEXT\n"
+            << "  --seconds S         Target time per measurement (default: 0.2)\n"
+            << "  --repeats N         Measurements per case, median reported (default: 5)\n"
+            << "  --csv               Machine-readable output\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg(juce::CharPointer_UTF8(argv[i]));
+        auto hasValue = i + 1 < argc;
+
+        if (arg == "--full")                         options.full = true;
+        else if (arg == "--csv")                     options.csv = true;
+        else if (arg == "--filter" && hasValue)      options.filter = juce::CharPointer_UTF8(argv[++i]);
+        else if (arg == "--seconds" && hasValue)     options.secondsPerCase = juce::jmax(0.01, juce::String(argv[++i]).getDoubleValue());
+        else if (arg == "--repeats" && hasValue)     options.repeats = juce::jmax(1, juce::String(argv[++i]).getIntValue());
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    juce::ScopedNoDenormals noDenormals;
+
+    if (options.csv)
+        std::cout << "benchmark,case,ns_per_sample,budget_percent" << std::endl;
+
+    const int blockSizes[] = { 16, 32, 64, 128, 256, 512, 1024, 2048, 4096, 8192 };
+    const double sampleRates[] = { 44100.0, 48000.0, 96000.0, 192000.0, 384000.0 };
+
+    std::vector<Config> features;
+    {
+        Config c;
+        features.push_back(c);
+        c.zeroCrossing = true;                  features.push_back(c);
+        c = {}; c.listen = true;                features.push_back(c);
+        c = {}; c.hpf = true;                   features.push_back(c);
+        c = {}; c.lpf = true;                   features.push_back(c);
+        c = {}; c.hpf = c.lpf = true;           features.push_back(c);
+        for (int shape = 1; shape < 4; ++shape)
+        {
+            c = {};
+            c.curveShape = shape;
+            features.push_back(c);
+        }
+    }
+
+    if (wanted(options, "Ducker::process"))
+    {
+        if (options.full)
+        {
+            for (auto& feature : features)
+                for (auto rate : sampleRates)
+                    for (auto block : blockSizes)
+                        for (int channels = 1; channels <= 2; ++channels)
+                        {
+                            auto c = feature;
+                            c.sampleRate = rate;
+                            c.blockSize = block;
+                            c.numChannels = channels;
+                            benchDucker(options, c);
+                        }
+        }
+        else
+        {
+            // One axis at a time around 48 kHz / 512 / stereo / default
+            for (auto block : blockSizes)
+            {
+                Config c;
+                c.blockSize = block;
+                benchDucker(options, c);
+            }
+
+            for (auto rate : sampleRates)
+            {
+                Config c;
+                c.sampleRate = rate;
+                benchDucker(options, c);
+            }
+
+            for (int channels = 1; channels <= 2; ++channels)
+            {
+                Config c;
+                c.numChannels = channels;
+                benchDucker(options, c);
+            }
+
+            for (auto& feature : features)
+                benchDucker(options, feature);
+        }
+    }
+
+    benchComponents(options);
+    return 0;
+}
@@ -0,0 +1,1002 @@
+// ducker_golden - golden-render accuracy harness.
+//
+// Renders a corpus of generated signals through the frozen scalar reference
+// (ReferenceDucker.h) and through every processing path that claims to
+// produce the same result: Ducker::process itself, gain-track replay, and
+// the offline renderers (plain, segment-parallel, sweep, cached, pipe).
+// Each result is compared with the reference for maximum and RMS sample
+// error, gain-curve deviation in dB and duck onset/release timing, against
+// tolerances that can be set on the command line. An optimised kernel is
+// added as one more entry in makeVariants().
+//
+// --block-sizes checks instead that each path gives identical output
+// whatever block size it runs at, including irregular host block sizes.
+
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <iostream>
+#include "DSP/Ducker.h"
+#include "Offline/CachedRenderer.h"
+#include "Offline/PcmPipe.h"
+#include "Offline/SegmentRenderer.h"
+#include "Offline/SweepRenderer.h"
+#include "ReferenceDucker.h"
+
+namespace
+{
+    struct Tolerances
+    {
+        float maxError = 1.0e-6f;     // absolute, per sample
+        float rmsError = 1.0e-7f;
+        float gainDb = 1.0e-4f;       // gain-curve deviation
+        int timingSamples = 0;        // duck onset/release shift
+    };
+
+    struct Options
+    {
+        double sampleRate = 48000.0;
+        double seconds = 6.0;
+        int blockSize = 512;
+        bool blockSizeMode = false;
+        std::vector<int> blockSizes { 1, 3, 16, 64, 511, 4096, 0 };   // 0: irregular
+        float blockTolerance = 0.0f;
+        Tolerances tolerances;
+        juce::String filter;
+        bool csv = false;
+        bool custom = false;
+        DuckerSettings customSettings;
+    };
+
+    //==============================================================================
+    // Corpus
+
+    struct Case
+    {
+        juce::String name;
+        juce::AudioBuffer<float> main, key;
+        double sampleRate = 48000.0;
+
+        // File copies for the file-based paths (32-bit float WAV)
+        juce::File mainFile, keyFile;
+    };
+
+    struct Config
+    {
+        juce::String name;
+        DuckerSettings settings;
+    };
+
+    // Chord bed with a little noise, like a music stem
+    void fillMusicBed(juce::AudioBuffer<float>& buffer, double sampleRate, juce::Random& random)
+    {
+        const double chord[] = { 110.0, 164.8, 220.0, 277.2, 329.6 };
+
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            auto t = i / sampleRate;
+            float bed = 0.0f;
+            for (auto f : chord)
+                bed += 0.06f * (float)std::sin(juce::MathConstants<double>::twoPi * f * t);
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.setSample(ch, i, bed + 0.02f * (random.nextFloat() * 2.0f - 1.0f));
+        }
+    }
+
+    void fillKickLoop(juce::AudioBuffer<float>& key, double sampleRate)
+    {
+        auto period = (int)(0.5 * sampleRate);   // 120 BPM
+
+        for (int i = 0; i < key.getNumSamples(); ++i)
+        {
+            auto t = (i % period) / sampleRate;
+            auto phase = juce::MathConstants<double>::twoPi * (50.0 * t + 100.0 * 0.03 * (1.0 - std::exp(-t / 0.03)));
+            auto value = (float)(0.9 * std::exp(-t / 0.12) * std::sin(phase));
+
+            for (int ch = 0; ch < key.getNumChannels(); ++ch)
+                key.setSample(ch, i, value);
+        }
+    }
+
+    // Syllable-rate noise bursts in phrases, with pauses between them
+    void fillSpeech(juce::AudioBuffer<float>& key, double sampleRate, juce::Random& random)
+    {
+        for (int i = 0; i < key.getNumSamples(); ++i)
+        {
+            auto t = i / sampleRate;
+            auto phrase = std::fmod(t, 3.0) < 2.0 ? 1.0f : 0.0f;
+            auto syllable = (float)juce::jmax(0.0, std::sin(juce::MathConstants<double>::pi * 4.5 * t));
+            auto value = phrase * syllable * 0.4f * (random.nextFloat() * 2.0f - 1.0f);
+
+            for (int ch = 0; ch < key.getNumChannels(); ++ch)
+                key.setSample(ch, i, value);
+        }
+    }
+
+    // Logarithmic sine sweep, 20 Hz to 20 kHz (or Nyquist) at -6 dBFS
+    void fillSweep(juce::AudioBuffer<float>& key, double sampleRate)
+    {
+        auto duration = key.getNumSamples() / sampleRate;
+        auto f0 = 20.0, f1 = juce::jmin(20000.0, sampleRate * 0.45);
+        auto k = std::log(f1 / f0);
+
+        for (int i = 0; i < key.getNumSamples(); ++i)
+        {
+            auto t = i / sampleRate;
+            auto phase = juce::MathConstants<double>::twoPi * f0 * duration / k * (std::exp(t / duration * k) - 1.0);
+            auto value = (float)(0.5 * std::sin(phase));
+
+            for (int ch = 0; ch < key.getNumChannels(); ++ch)
+                key.setSample(ch, i, value);
+        }
+    }
+
+    // A full-scale burst decaying through the subnormal range (below 1e-38)
+    void fillDenormalTail(juce::AudioBuffer<float>& buffer, double sampleRate, double frequency)
+    {
+        auto length = buffer.getNumSamples();
+        auto decayPerSample = std::log(1.0e-44) / (0.8 * length);
+
+        for (int i = 0; i < length; ++i)
+        {
+            auto value = (float)(std::exp(decayPerSample * i)
+                                 * std::sin(juce::MathConstants<double>::twoPi * frequency * i / sampleRate));
+
+            for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                buffer.setSample(ch, i, value);
+        }
+    }
+
+    std::vector<std::unique_ptr<Case>> makeCorpus(const Options& options)
+    {
+        std::vector<std::unique_ptr<Case>> corpus;
+        auto length = (int)(options.seconds * options.sampleRate);
+        auto rate = options.sampleRate;
+
+        auto add = [&](const juce::String& name, int mainChannels) -> Case&
+        {
+            corpus.push_back(std::make_unique<Case>());
+            auto& c = *corpus.back();
+            c.name = name;
+            c.sampleRate = rate;
+            c.main.setSize(mainChannels, length);
+            c.key.setSize(2, length);
+            c.main.clear();
+            c.key.clear();
+            return c;
+        };
+
+        juce::Random random(20240611);
+
+        { auto& c = add("kick-loop", 2);   fillMusicBed(c.main, rate, random); fillKickLoop(c.key, rate); }
+        { auto& c = add("speech", 2);      fillMusicBed(c.main, rate, random); fillSpeech(c.key, rate, random); }
+        { auto& c = add("speech-mono", 1); fillMusicBed(c.main, rate, random); fillSpeech(c.key, rate, random); }
+        { auto& c = add("sweep", 2);       fillMusicBed(c.main, rate, random); fillSweep(c.key, rate); }
+        { auto& c = add("silence", 2);     fillMusicBed(c.main, rate, random); }
+        { auto& c = add("denormal-tail", 2); fillDenormalTail(c.main, rate, 330.0); fillDenormalTail(c.key, rate, 90.0); }
+
+        return corpus;
+    }
+
+    std::vector<Config> makeConfigs(const Options& options)
+    {
+        if (options.custom)
+            return { { "custom", options.customSettings } };
+
+        std::vector<Config> configs;
+        auto add = [&](const juce::String& name, std::initializer_list<const char*> assignments)
+        {
+            Config c { name, {} };
+            for (auto* a : assignments)
+                c.settings.setFromString(a);
+            configs.push_back(c);
+        };
+
+        add("default", {});
+        add("fast", { "attack=0.1", "hold=0", "release=10" });
+        add("slow", { "attack=100", "hold=500", "release=2000" });
+        add("filtered", { "scHPFEnabled=1", "scHPFFreq=200", "scLPFEnabled=1", "scLPFFreq=4000" });
+        add("exp-curve", { "curveShape=1" });
+        add("log-curve", { "curveShape=2" });
+        add("s-curve", { "curveShape=3" });
+        add("parallel", { "mix=50", "duckAmount=-40", "range=-12" });
+        add("no-lookahead", { "lookAhead=0" });
+        add("max-lookahead", { "lookAhead=20" });
+        add("zero-crossing", { "zeroCrossing=1" });
+        add("listen", { "scListen=1", "scHPFEnabled=1", "scHPFFreq=300" });
+        return configs;
+    }
+
+    //==============================================================================
+    // File helpers
+
+    bool writeWav(const juce::File& file, const juce::AudioBuffer<float>& buffer, double sampleRate)
+    {
+        file.deleteFile();
+        auto stream = std::make_unique<juce::FileOutputStream>(file);
+        if (stream->failedToOpen())
+            return false;
+
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate,
+                                                                            (unsigned int)buffer.getNumChannels(),
+                                                                            32, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release();
+        return writer->writeFromAudioSampleBuffer(buffer, 0, buffer.getNumSamples());
+    }
+
+    bool readWav(const juce::File& file, juce::AudioBuffer<float>& buffer, juce::String& error)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr)
+        {
+            error = "Could not read " + file.getFullPathName();
+            return false;
+        }
+
+        buffer.setSize((int)reader->numChannels, (int)reader->lengthInSamples);
+        return reader->read(&buffer, 0, (int)reader->lengthInSamples, 0, true, true);
+    }
+
+    bool readGainTrack(const juce::File& file, std::vector<float>& gain, juce::String& error)
+    {
+        GainTrackReader reader;
+        if (!reader.open(file, error))
+            return false;
+
+        gain.resize((size_t)reader.getLengthInSamples());
+        reader.read(gain.data(), (int)gain.size());
+        return true;
+    }
+
+    //==============================================================================
+    // Paths under test
+
+    struct Rendered
+    {
+        juce::AudioBuffer<float> output;
+        std::vector<float> gain;       // empty if the path cannot report it
+    };
+
+    struct RenderContext
+    {
+        const Case& input;
+        const DuckerSettings& settings;
+        int blockSize;                 // 0: irregular (in-memory paths only)
+        juce::File workDir;
+        juce::ThreadPool& pool;
+    };
+
+    struct Variant
+    {
+        juce::String name;
+        Tolerances floor { 0.0f, 0.0f, 0.0f, 0 };   // resolution inherent to the path
+        bool supportsMainDependent = true;   // zero-crossing gating and listen
+        bool irregularBlocks = false;
+        std::function<bool(const RenderContext&, Rendered&, juce::String&)> render;
+    };
+
+    // Deterministic irregular block pattern, like a host splitting buffers
+    // around automation points
+    int nextIrregularBlock(juce::Random& random)
+    {
+        const int sizes[] = { 1, 2, 7, 31, 64, 127, 128, 480, 512, 1000, 1024, 2048 };
+        return sizes[random.nextInt((int)std::size(sizes))];
+    }
+
+    // Runs Ducker over the whole case and returns aligned output and gain,
+    // with input past the end read as zero (as OfflineRenderer does)
+    void renderDucker(const RenderContext& context, Rendered& rendered)
+    {
+        const auto& main = context.input.main;
+        auto length = main.getNumSamples();
+        auto numChannels = main.getNumChannels();
+        auto maxBlock = context.blockSize > 0 ? context.blockSize : 2048;
+
+        Ducker ducker;
+        ducker.prepare(context.input.sampleRate, maxBlock);
+        context.settings.applyTo(ducker);
+        auto latency = ducker.getLatencyInSamples();
+        auto total = length + latency;
+
+        juce::AudioBuffer<float> padded(numChannels, total), key(2, total);
+        padded.clear();
+        key.clear();
+        for (int ch = 0; ch < numChannels; ++ch)
+            padded.copyFrom(ch, 0, main, ch, 0, length);
+        for (int ch = 0; ch < 2; ++ch)
+            key.copyFrom(ch, 0, context.input.key, ch, 0, length);
+
+        std::vector<float> gain((size_t)total);
+        juce::Random random(77);
+
+        for (int pos = 0; pos < total;)
+        {
+            auto numSamples = juce::jmin(context.blockSize > 0 ? context.blockSize : nextIrregularBlock(random), total - pos);
+
+            juce::AudioBuffer<float> mainBlock(padded.getArrayOfWritePointers(), numChannels, pos, numSamples);
+            juce::AudioBuffer<float> keyBlock(key.getArrayOfWritePointers(), 2, pos, numSamples);
+            ducker.process(mainBlock, keyBlock, gain.data() + pos);
+            pos += numSamples;
+        }
+
+        rendered.output.setSize(numChannels, length);
+        for (int ch = 0; ch < numChannels; ++ch)
+            rendered.output.copyFrom(ch, 0, padded, ch, latency, length);
+        rendered.gain.assign(gain.begin() + latency, gain.end());
+    }
+
+    // Captured gain applied to the main signal in one multiply
+    void replayGain(const Case& input, const std::vector<float>& gain, Rendered& rendered)
+    {
+        rendered.output.makeCopyOf(input.main);
+        Ducker::applyGainCurve(rendered.output, gain.data(), 0, rendered.output.getNumSamples());
+        rendered.gain = gain;
+    }
+
+    RenderJob makeJob(const RenderContext& context, const juce::String& outputName)
+    {
+        RenderJob job;
+        job.mainFile = context.input.mainFile;
+        job.sidechainFile = context.input.keyFile;
+        job.outputFile = context.workDir.getChildFile(outputName);
+        return job;
+    }
+
+    std::vector<Variant> makeVariants()
+    {
+        std::vector<Variant> variants;
+
+        // Ducker::process at the host block size - the plugin's own path
+        {
+            Variant v;
+            v.name = "ducker";
+            v.irregularBlocks = true;
+            v.render = [](const RenderContext& c, Rendered& r, juce::String&)
+            {
+                renderDucker(c, r);
+                return true;
+            };
+            variants.push_back(v);
+        }
+
+        // Detection captured as a gain track, then replayed
+        {
+            Variant v;
+            v.name = "replay";
+            v.supportsMainDependent = false;
+            v.irregularBlocks = true;
+            v.render = [](const RenderContext& c, Rendered& r, juce::String&)
+            {
+                Rendered captured;
+                renderDucker(c, captured);
+                replayGain(c.input, captured.gain, r);
+                return true;
+            };
+            variants.push_back(v);
+        }
+
+        // As replay, through the .dgain codec (0.01 dB steps)
+        {
+            Variant v;
+            v.name = "gaintrack";
+            v.floor = { 1.0e-3f, 2.0e-4f, 0.0051f, 1 };
+            v.supportsMainDependent = false;
+            v.render = [](const RenderContext& c, Rendered& r, juce::String& error)
+            {
+                Rendered captured;
+                renderDucker(c, captured);
+
+                auto file = c.workDir.getChildFile("track.dgain");
+                GainTrackWriter writer;
+                if (!writer.open(file, c.input.sampleRate, error))
+                    return false;
+                writer.write(captured.gain.data(), (int)captured.gain.size());
+                if (!writer.finish())
+                {
+                    error = "Could not write " + file.getFullPathName();
+                    return false;
+                }
+
+                std::vector<float> decoded;
+                if (!readGainTrack(file, decoded, error))
+                    return false;
+
+                replayGain(c.input, decoded, r);
+                return true;
+            };
+            variants.push_back(v);
+        }
+
+        // OfflineRenderer through files, exporting the gain track alongside
+        {
+            Variant v;
+            v.name = "offline";
+            v.floor.gainDb = 0.0051f;
+            v.floor.timingSamples = 1;
+            v.render = [](const RenderContext& c, Rendered& r, juce::String& error)
+            {
+                OfflineRenderer renderer(c.settings, c.blockSize, 32);
+                auto job = makeJob(c, "offline.wav");
+                job.exportGainTrack = c.workDir.getChildFile("offline.dgain");
+
+                auto result = renderer.render(job);
+                if (!result.ok)
+                {
+                    error = result.error;
+                    return false;
+                }
+
+                return readWav(job.outputFile, r.output, error) && readGainTrack(job.exportGainTrack, r.gain, error);
+            };
+            variants.push_back(v);
+        }
+
+        // Segment-parallel render; segments converge from their overlap
+        {
+            Variant v;
+            v.name = "segments";
+            v.floor = { 1.0e-4f, 1.0e-5f, 0.0f, 0 };
+            v.render = [](const RenderContext& c, Rendered& r, juce::String& error)
+            {
+                OfflineRenderer renderer(c.settings, c.blockSize, 32);
+                SegmentRenderer segments(renderer);
+                SegmentRenderOptions segmentOptions;
+                segmentOptions.numSegments = 4;
+
+                auto job = makeJob(c, "segments.wav");
+                auto result = segments.render(job, segmentOptions, c.pool);
+                if (!result.ok)
+                {
+                    error = result.error;
+                    return false;
+                }
+
+                return readWav(job.outputFile, r.output, error);
+            };
+            variants.push_back(v);
+        }
+
+        // One-variant sweep: the structure-of-arrays envelope lanes
+        {
+            Variant v;
+            v.name = "sweep";
+            v.supportsMainDependent = false;
+            v.render = [](const RenderContext& c, Rendered& r, juce::String& error)
+            {
+                OfflineRenderer renderer(c.settings, c.blockSize, 32);
+                SweepRenderer sweep(renderer, { { c.settings, "golden" } });
+
+                auto job = makeJob(c, "sweep.wav");
+                auto result = sweep.render(job);
+                if (!result.ok)
+                {
+                    error = result.error;
+                    return false;
+                }
+
+                return readWav(SweepRenderer::getVariantFile(job.outputFile, sweep.getVariants().front()), r.output, error);
+            };
+            variants.push_back(v);
+        }
+
+        // Chunk cache: a cold render fills it, the warm re-render is compared
+        {
+            Variant v;
+            v.name = "cached";
+            v.floor = { 1.0e-3f, 2.0e-4f, 0.0f, 0 };
+            v.render = [](const RenderContext& c, Rendered& r, juce::String& error)
+            {
+                OfflineRenderer renderer(c.settings, c.blockSize, 32);
+                auto cacheDir = c.workDir.getChildFile("cache");
+                cacheDir.deleteRecursively();
+                CachedRenderer cached(renderer, cacheDir);
+
+                auto job = makeJob(c, "cached.wav");
+                for (int pass = 0; pass < 2; ++pass)
+                {
+                    auto result = cached.render(job);
+                    if (!result.ok)
+                    {
+                        error = result.error;
+                        return false;
+                    }
+                }
+
+                return readWav(job.outputFile, r.output, error);
+            };
+            variants.push_back(v);
+        }
+
+        // Raw PCM filter through temporary files standing in for pipes
+        {
+            Variant v;
+            v.name = "pipe";
+            v.render = [](const RenderContext& c, Rendered& r, juce::String& error)
+            {
+                const auto& main = c.input.main;
+                auto numChannels = main.getNumChannels();
+
+                auto writeInterleaved = [](std::FILE* file, const juce::AudioBuffer<float>& buffer)
+                {
+                    for (int i = 0; i < buffer.getNumSamples(); ++i)
+                        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+                        {
+                            auto sample = juce::ByteOrder::swapIfBigEndian(buffer.getSample(ch, i));
+                            std::fwrite(&sample, sizeof(sample), 1, file);
+                        }
+                    std::rewind(file);
+                };
+
+                std::unique_ptr<std::FILE, int (*)(std::FILE*)> mainIn(std::tmpfile(), std::fclose),
+                                                                 keyIn(std::tmpfile(), std::fclose),
+                                                                 out(std::tmpfile(), std::fclose);
+                if (mainIn == nullptr || keyIn == nullptr || out == nullptr)
+                {
+                    error = "Could not create temporary files";
+                    return false;
+                }
+
+                writeInterleaved(mainIn.get(), main);
+                writeInterleaved(keyIn.get(), c.input.key);
+
+                PipeOptions pipeOptions;
+                pipeOptions.sampleRate = c.input.sampleRate;
+                pipeOptions.blockSize = c.blockSize;
+                pipeOptions.main.numChannels = numChannels;
+                pipeOptions.sidechain.numChannels = 2;
+                pipeOptions.output.numChannels = numChannels;
+
+                PipeRenderer pipe(c.settings, pipeOptions);
+                if (!pipe.run(mainIn.get(), keyIn.get(), out.get(), error))
+                    return false;
+
+                std::rewind(out.get());
+                r.output.setSize(numChannels, main.getNumSamples());
+                r.output.clear();
+                for (int i = 0; i < main.getNumSamples(); ++i)
+                    for (int ch = 0; ch < numChannels; ++ch)
+                    {
+                        float sample = 0.0f;
+                        if (std::fread(&sample, sizeof(sample), 1, out.get()) != 1)
+                        {
+                            error = "Pipe output is shorter than its input";
+                            return false;
+                        }
+                        r.output.setSample(ch, i, juce::ByteOrder::swapIfBigEndian(sample));
+                    }
+                return true;
+            };
+            variants.push_back(v);
+        }
+
+        return variants;
+    }
+
+    //==============================================================================
+    // Comparison
+
+    struct Comparison
+    {
+        double maxError = 0.0;
+        double rmsError = 0.0;
+        double gainDb = -1.0;          // -1: not available
+        int timingSamples = -1;        // -1: not available
+        int eventCountDelta = 0;
+        bool finite = true;
+        bool sameLength = true;
+    };
+
+    // Sample positions where the gain crosses -1 dB, downwards (onsets)
+    // and upwards (releases)
+    struct DuckEvents
+    {
+        std::vector<int> onsets, releases;
+    };
+
+    DuckEvents findDuckEvents(const std::vector<float>& gain)
+    {
+        const float level = juce::Decibels::decibelsToGain(-1.0f);
+        DuckEvents events;
+        bool ducked = false;
+
+        for (size_t i = 0; i < gain.size(); ++i)
+        {
+            bool nowDucked = gain[i] < level;
+            if (nowDucked != ducked)
+                (nowDucked ? events.onsets : events.releases).push_back((int)i);
+            ducked = nowDucked;
+        }
+
+        return events;
+    }
+
+    // Largest distance from a reference event to the nearest test event
+    int maxEventShift(const std::vector<int>& reference, const std::vector<int>& test)
+    {
+        int worst = 0;
+        for (auto position : reference)
+        {
+            if (test.empty())
+                return std::numeric_limits<int>::max();
+
+            auto it = std::lower_bound(test.begin(), test.end(), position);
+            auto nearest = std::numeric_limits<int>::max();
+            if (it != test.end())    nearest = *it - position;
+            if (it != test.begin())  nearest = juce::jmin(nearest, position - *std::prev(it));
+            worst = juce::jmax(worst, nearest);
+        }
+        return worst;
+    }
+
+    Comparison compare(const ReferenceDucker::Render& reference, const Rendered& test)
+    {
+        Comparison result;
+        const auto& a = reference.output;
+        const auto& b = test.output;
+
+        if (a.getNumChannels() != b.getNumChannels() || a.getNumSamples() != b.getNumSamples())
+        {
+            result.sameLength = false;
+            return result;
+        }
+
+        double sumSquares = 0.0;
+        for (int ch = 0; ch < a.getNumChannels(); ++ch)
+        {
+            auto* x = a.getReadPointer(ch);
+            auto* y = b.getReadPointer(ch);
+
+            for (int i = 0; i < a.getNumSamples(); ++i)
+            {
+                if (!std::isfinite(y[i]))
+                    result.finite = false;
+
+                auto d = (double)y[i] - (double)x[i];
+                result.maxError = juce::jmax(result.maxError, std::abs(d));
+                sumSquares += d * d;
+            }
+        }
+        result.rmsError = std::sqrt(sumSquares / juce::jmax(1, a.getNumChannels() * a.getNumSamples()));
+
+        if (test.gain.size() == reference.gain.size())
+        {
+            const float floor = juce::Decibels::decibelsToGain(-120.0f);
+            result.gainDb = 0.0;
+            for (size_t i = 0; i < reference.gain.size(); ++i)
+            {
+                auto d = std::abs(juce::Decibels::gainToDecibels(juce::jmax(floor, test.gain[i]), -120.0f)
+                                  - juce::Decibels::gainToDecibels(juce::jmax(floor, reference.gain[i]), -120.0f));
+                result.gainDb = juce::jmax(result.gainDb, (double)d);
+            }
+
+            auto expected = findDuckEvents(reference.gain);
+            auto actual = findDuckEvents(test.gain);
+            result.eventCountDelta = (int)(actual.onsets.size() + actual.releases.size())
+                                   - (int)(expected.onsets.size() + expected.releases.size());
+            result.timingSamples = juce::jmax(maxEventShift(expected.onsets, actual.onsets),
+                                              maxEventShift(expected.releases, actual.releases));
+        }
+
+        return result;
+    }
+
+    bool passes(const Comparison& c, const Tolerances& global, const Tolerances& floor)
+    {
+        if (!c.sameLength || !c.finite)
+            return false;
+
+        return c.maxError <= juce::jmax(global.maxError, floor.maxError)
+            && c.rmsError <= juce::jmax(global.rmsError, floor.rmsError)
+            && (c.gainDb < 0.0 || c.gainDb <= juce::jmax(global.gainDb, floor.gainDb))
+            && (c.timingSamples < 0 || (c.eventCountDelta == 0
+                                        && c.timingSamples <= juce::jmax(global.timingSamples, floor.timingSamples)));
+    }
+
+    bool wanted(const Options& options, const juce::String& name)
+    {
+        return options.filter.isEmpty() || name.containsIgnoreCase(options.filter);
+    }
+
+    bool isMainDependent(const DuckerSettings& settings)
+    {
+        return settings.zeroCrossing || settings.scListen;
+    }
+
+    juce::String formatOptional(double value, int decimals)
+    {
+        return value < 0.0 ? juce::String("n/a") : juce::String(value, decimals);
+    }
+
+    //==============================================================================
+    // Modes
+
+    struct Totals
+    {
+        int passed = 0, failed = 0, errors = 0;
+    };
+
+    void runGolden(const Options& options, std::vector<std::unique_ptr<Case>>& corpus, const std::vector<Config>& configs,
+                   const std::vector<Variant>& variants, const juce::File& workDir, juce::ThreadPool& pool, Totals& totals)
+    {
+        if (options.csv)
+            std::cout << "variant,case,config,max_error,rms_error,gain_db,timing_samples,event_delta,pass" << std::endl;
+        else
+            std::cout << juce::String::formatted("%-10s %-14s %-14s %10s %10s %9s %6s %5s",
+                                                 "variant", "case", "config", "max err", "rms err", "gain dB", "shift", "")
+                      << std::endl;
+
+        for (auto& input : corpus)
+            for (auto& config : configs)
+            {
+                ReferenceDucker::Render reference;
+                ReferenceDucker::render(config.settings, input->sampleRate, input->main, input->key, reference);
+
+                for (auto& variant : variants)
+                {
+                    auto name = variant.name + "/" + input->name + "/" + config.name;
+                    if (!wanted(options, name))
+                        continue;
+                    if (!variant.supportsMainDependent && isMainDependent(config.settings))
+                        continue;
+
+                    Rendered rendered;
+                    juce::String error;
+                    RenderContext context { *input, config.settings, options.blockSize, workDir, pool };
+
+                    if (!variant.render(context, rendered, error))
+                    {
+                        ++totals.errors;
+                        std::cout << name << ": " << error << std::endl;
+                        continue;
+                    }
+
+                    auto c = compare(reference, rendered);
+                    auto ok = passes(c, options.tolerances, variant.floor);
+                    ++(ok ? totals.passed : totals.failed);
+
+                    auto status = !c.sameLength ? juce::String("LENGTH")
+                                : !c.finite     ? juce::String("NONFINITE")
+                                : ok            ? juce::String("ok")
+                                                : juce::String("FAIL");
+
+                    if (options.csv)
+                        std::cout << variant.name << "," << input->name << "," << config.name << ","
+                                  << c.maxError << "," << c.rmsError << "," << c.gainDb << ","
+                                  << c.timingSamples << "," << c.eventCountDelta << "," << (ok ? 1 : 0) << std::endl;
+                    else
+                        std::cout << juce::String::formatted("%-10s %-14s %-14s %10.3e %10.3e %9s %6s %s",
+                                                             variant.name.toRawUTF8(), input->name.toRawUTF8(),
+                                                             config.name.toRawUTF8(), c.maxError, c.rmsError,
+                                                             formatOptional(c.gainDb, 5).toRawUTF8(),
+                                                             (c.timingSamples < 0 ? juce::String("n/a")
+                                                                                  : juce::String(c.timingSamples)
+                                                                                    + (c.eventCountDelta != 0 ? "!" : "")).toRawUTF8(),
+                                                             status.toRawUTF8())
+                                  << std::endl;
+                }
+            }
+    }
+
+    // Each path against itself at the first block size in the list
+    void runBlockSizes(const Options& options, std::vector<std::unique_ptr<Case>>& corpus, const std::vector<Config>& configs,
+                       const std::vector<Variant>& variants, const juce::File& workDir, juce::ThreadPool& pool, Totals& totals)
+    {
+        for (auto& input : corpus)
+            for (auto& config : configs)
+                for (auto& variant : variants)
+                {
+                    auto name = variant.name + "/" + input->name + "/" + config.name;
+                    if (!wanted(options, name))
+                        continue;
+                    if (!variant.supportsMainDependent && isMainDependent(config.settings))
+                        continue;
+
+                    Rendered first;
+                    juce::String firstBlock;
+                    float worst = 0.0f;
+                    juce::String worstBlock, error;
+                    bool sameLength = true;
+
+                    for (auto blockSize : options.blockSizes)
+                    {
+                        if (blockSize == 0 && !variant.irregularBlocks)
+                            continue;
+
+                        Rendered rendered;
+                        RenderContext context { *input, config.settings, blockSize, workDir, pool };
+                        if (!variant.render(context, rendered, error))
+                            break;
+
+                        auto label = blockSize > 0 ? juce::String(blockSize) : juce::String("irregular");
+                        if (firstBlock.isEmpty())
+                        {
+                            first.output.makeCopyOf(rendered.output);
+                            firstBlock = label;
+                            continue;
+                        }
+
+                        if (rendered.output.getNumSamples() != first.output.getNumSamples()
+                            || rendered.output.getNumChannels() != first.output.getNumChannels())
+                        {
+                            sameLength = false;
+                            worstBlock = label;
+                            break;
+                        }
+
+                        for (int ch = 0; ch < first.output.getNumChannels(); ++ch)
+                            for (int i = 0; i < first.output.getNumSamples(); ++i)
+                            {
+                                auto d = std::abs(rendered.output.getSample(ch, i) - first.output.getSample(ch, i));
+                                if (!(d <= worst))   // also catches NaN
+                                {
+                                    worst = std::isfinite(d) ? d : std::numeric_limits<float>::infinity();
+                                    worstBlock = label;
+                                }
+                            }
+                    }
+
+                    if (error.isNotEmpty())
+                    {
+                        ++totals.errors;
+                        std::cout << name << ": " << error << std::endl;
+                        continue;
+                    }
+
+                    auto ok = sameLength && worst <= options.blockTolerance;
+                    ++(ok ? totals.passed : totals.failed);
+
+                    if (options.csv)
+                        std::cout << name << "," << worst << "," << worstBlock << "," << (ok ? 1 : 0) << std::endl;
+                    else
+                        std::cout << name.paddedRight(' ', 40) << " max diff vs block " << firstBlock << ": "
+                                  << (sameLength ? juce::String(worst, 9) : juce::String("length mismatch"))
+                                  << (worstBlock.isNotEmpty() ? " (block " + worstBlock + ")" : juce::String())
+                                  << (ok ? "  ok" : "  FAIL") << std::endl;
+                }
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: ducker_golden [options]\n"
+            << "\n"
+            << "Compares every processing path against the frozen scalar reference over a\n"
+            << "generated corpus. Exits non-zero if anything is outside tolerance.\n"
+            << "\n"
+            << "Options:\n"
+            << "  --rate HZ              Sample rate (default: 48000)\n"
+            << "  --seconds S            Length of each corpus signal (default: 6)\n"
+            << "  --block N              Block size for the golden comparison (default: 512)\n"
+            << "  --filter TEXT          Only run variant/case/config names containing TEXT\n"
+            << "  --preset FILE          Run one config from a plugin state XML instead of the built-in set\n"
+            << "  --set ID=VALUE         Override a parameter of that config (repeatable)\n"
+            << "  --max-error X          Max absolute sample error (default: 1e-6)\n"
+            << "  --rms-error X          Max RMS sample error (default: 1e-7)\n"
+            << "  --gain-db X            Max gain-curve deviation in dB (default: 1e-4)\n"
+            << "  --timing N             Max duck onset/release shift in samples (default: 0)\n"
+            << "  --block-sizes [LIST]   Check block-size invariance instead; LIST defaults to\n"
+            << "                         1,3,16,64,511,4096,0 (0 = irregular host blocks)\n"
+            << "  --block-tolerance X    Allowed difference between block sizes (default: 0)\n"
+            << "  --csv                  Machine-readable output\n"
+            << "  --list                 List variants, cases and configs\n"
+            << "\n"
+            << "Paths with an inherent resolution (0.01 dB gain tracks, segment overlap)\n"
+            << "are held to the looser of that resolution and the tolerance given.\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg(juce::CharPointer_UTF8(argv[i]));
+        auto hasValue = i + 1 < argc;
+        auto value = hasValue ? juce::String(juce::CharPointer_UTF8(argv[i + 1])) : juce::String();
+
+        if (arg == "--csv")                              options.csv = true;
+        else if (arg == "--list")                        list = true;
+        else if (arg == "--rate" && hasValue)            { options.sampleRate = juce::jmax(8000.0, value.getDoubleValue()); ++i; }
+        else if (arg == "--seconds" && hasValue)         { options.seconds = juce::jmax(0.5, value.getDoubleValue()); ++i; }
+        else if (arg == "--block" && hasValue)           { options.blockSize = juce::jmax(1, value.getIntValue()); ++i; }
+        else if (arg == "--filter" && hasValue)          { options.filter = value; ++i; }
+        else if (arg == "--max-error" && hasValue)       { options.tolerances.maxError = value.getFloatValue(); ++i; }
+        else if (arg == "--rms-error" && hasValue)       { options.tolerances.rmsError = value.getFloatValue(); ++i; }
+        else if (arg == "--gain-db" && hasValue)         { options.tolerances.gainDb = value.getFloatValue(); ++i; }
+        else if (arg == "--timing" && hasValue)          { options.tolerances.timingSamples = juce::jmax(0, value.getIntValue()); ++i; }
+        else if (arg == "--block-tolerance" && hasValue) { options.blockTolerance = value.getFloatValue(); ++i; }
+        else if (arg == "--block-sizes")
+        {
+            options.blockSizeMode = true;
+            if (hasValue && !value.startsWith("--"))
+            {
+                options.blockSizes.clear();
+                for (auto& token : juce::StringArray::fromTokens(value, ",", ""))
+                    options.blockSizes.push_back(juce::jmax(0, token.getIntValue()));
+                ++i;
+            }
+        }
+        else if (arg == "--preset" && hasValue)
+        {
+            juce::String error;
+            if (!options.customSettings.loadPreset(juce::File::getCurrentWorkingDirectory().getChildFile(value), error))
+            {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+            options.custom = true;
+            ++i;
+        }
+        else if (arg == "--set" && hasValue)
+        {
+            if (!options.customSettings.setFromString(value))
+            {
+                std::cerr << "Unknown parameter: " << value << std::endl;
+                return 1;
+            }
+            options.custom = true;
+            ++i;
+        }
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    auto variants = makeVariants();
+    auto configs = makeConfigs(options);
+    auto corpus = makeCorpus(options);
+
+    if (list)
+    {
+        for (auto& v : variants)  std::cout << "variant " << v.name << std::endl;
+        for (auto& c : corpus)    std::cout << "case    " << c->name << std::endl;
+        for (auto& c : configs)   std::cout << "config  " << c.name << std::endl;
+        return 0;
+    }
+
+    auto workDir = juce::File::getSpecialLocation(juce::File::tempDirectory).getNonexistentChildFile("ducker_golden", "");
+    if (!workDir.createDirectory())
+    {
+        std::cerr << "Could not create " << workDir.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    for (auto& input : corpus)
+    {
+        input->mainFile = workDir.getChildFile(input->name + "_main.wav");
+        input->keyFile = workDir.getChildFile(input->name + "_key.wav");
+
+        if (!writeWav(input->mainFile, input->main, input->sampleRate)
+            || !writeWav(input->keyFile, input->key, input->sampleRate))
+        {
+            std::cerr << "Could not write corpus to " << workDir.getFullPathName() << std::endl;
+            workDir.deleteRecursively();
+            return 1;
+        }
+    }
+
+    juce::ThreadPool pool(juce::SystemStats::getNumCpus());
+    Totals totals;
+
+    if (options.blockSizeMode)
+        runBlockSizes(options, corpus, configs, variants, workDir, pool, totals);
+    else
+        runGolden(options, corpus, configs, variants, workDir, pool, totals);
+
+    workDir.deleteRecursively();
+
+    std::cout << "\n" << totals.passed << " passed, " << totals.failed << " failed, "
+              << totals.errors << " errors" << std::endl;
+
+    return totals.failed == 0 && totals.errors == 0 ? 0 : 1;
+}
@@ -0,0 +1,238 @@
+#pragma once
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include "Offline/DuckerSettings.h"
+
+// Frozen scalar reference of the ducking algorithm, for the golden harness.
+//
+// This is a self-contained copy of Ducker::process as it stood when the
+// harness was written (sidechain downmix, biquad HPF/LPF, envelope state
+// machine, curve shapes, range floor, zero-crossing gating, look-ahead delay
+// line, parallel mix and sidechain listen). It deliberately shares no code
+// with Source/DSP - not even DSPUtils - so an optimisation there cannot move
+// the reference along with it. Do not change it to match new behaviour:
+// an intended change of sound belongs in a new reference, not in this one.
+namespace ReferenceDucker
+{
+    // Aligned result: output[m] and gain[m] correspond to input sample m,
+    // the look-ahead delay already removed (as the offline renderers do).
+    struct Render
+    {
+        juce::AudioBuffer<float> output;
+        std::vector<float> gain;   // applied gain, mix included (left channel)
+    };
+
+    namespace detail
+    {
+        inline float linearToDecibels(float linear) { return linear > 0.0f ? 20.0f * std::log10(linear) : -100.0f; }
+        inline float decibelsToLinear(float dB)     { return std::pow(10.0f, dB / 20.0f); }
+
+        inline float coefficient(double sampleRate, float timeMs)
+        {
+            if (timeMs <= 0.0f) return 1.0f;
+            return 1.0f - std::exp(-1.0f / (static_cast<float>(sampleRate) * timeMs * 0.001f));
+        }
+
+        struct Biquad
+        {
+            float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f, a1 = 0.0f, a2 = 0.0f;
+            float x1 = 0.0f, x2 = 0.0f, y1 = 0.0f, y2 = 0.0f;
+
+            Biquad(double sampleRate, float freq, bool highPass)
+            {
+                const float q = 0.707f;
+                float w0 = 2.0f * 3.14159265358979323846f * freq / static_cast<float>(sampleRate);
+                float cosw0 = std::cos(w0);
+                float alpha = std::sin(w0) / (2.0f * q);
+                float a0 = 1.0f + alpha;
+
+                if (highPass)
+                {
+                    b0 = ((1.0f + cosw0) / 2.0f) / a0;
+                    b1 = (-(1.0f + cosw0)) / a0;
+                    b2 = ((1.0f + cosw0) / 2.0f) / a0;
+                }
+                else
+                {
+                    b0 = ((1.0f - cosw0) / 2.0f) / a0;
+                    b1 = (1.0f - cosw0) / a0;
+                    b2 = ((1.0f - cosw0) / 2.0f) / a0;
+                }
+
+                a1 = (-2.0f * cosw0) / a0;
+                a2 = (1.0f - alpha) / a0;
+            }
+
+            float process(float x)
+            {
+                float y = b0 * x + b1 * x1 + b2 * x2 - a1 * y1 - a2 * y2;
+                x2 = x1;
+                x1 = x;
+                y2 = y1;
+                y1 = y;
+                return y;
+            }
+        };
+
+        inline float applyCurveShape(float value, int shape)
+        {
+            switch (shape)
+            {
+                case 1:  return value * value;
+                case 2:  return std::sqrt(value);
+                case 3:  return 0.5f * (1.0f - std::cos(value * 3.14159265358979323846f));
+                default: return value;
+            }
+        }
+    }
+
+    // Renders main keyed by key (2 channels, or 1) with settings. Inputs are
+    // treated as zero past their end, and the whole signal is processed as
+    // one sample-by-sample pass, so the result has no notion of block size.
+    inline void render(const DuckerSettings& settings, double sampleRate,
+                       const juce::AudioBuffer<float>& main, const juce::AudioBuffer<float>& key, Render& result)
+    {
+        using namespace detail;
+
+        auto length = main.getNumSamples();
+        auto numChannels = main.getNumChannels();
+        bool stereo = numChannels > 1;
+        bool stereoKey = key.getNumChannels() > 1;
+
+        // Parameters, derived exactly as Ducker and its modules derive them
+        float threshold = settings.threshold;
+        float attackCoeff = coefficient(sampleRate, settings.attack);
+        float releaseCoeff = coefficient(sampleRate, settings.getReleaseMs());
+        int holdSamples = static_cast<int>(settings.getHoldMs() * 0.001f * sampleRate);
+        float duckedGain = std::max(decibelsToLinear(settings.duckAmount), decibelsToLinear(settings.range));
+        float wetMix = settings.mix / 100.0f;
+        float dryMix = 1.0f - wetMix;
+
+        Biquad hpf(sampleRate, settings.scHPFFreq, true);
+        Biquad lpf(sampleRate, settings.scLPFFreq, false);
+
+        auto delaySize = static_cast<int>(0.02 * sampleRate) + 1;
+        auto lookAhead = static_cast<int>(settings.lookAhead * 0.001f * sampleRate);
+        std::vector<float> delayL((size_t)delaySize, 0.0f), delayR((size_t)delaySize, 0.0f);
+        int writePos = 0;
+
+        enum { idle, attack, hold, release } state = idle;
+        float envelopeState = 0.0f;
+        int holdCounter = 0;
+
+        float lastL = 0.0f, lastR = 0.0f;
+        float pendingL = 1.0f, pendingR = 1.0f;
+
+        result.output.setSize(numChannels, length);
+        result.gain.assign((size_t)length, 1.0f);
+
+        for (int n = 0; n < length + lookAhead; ++n)
+        {
+            bool inRange = n < length;
+            float inL = inRange ? main.getSample(0, n) : 0.0f;
+            float inR = inRange && stereo ? main.getSample(1, n) : 0.0f;
+
+            float scInput = inRange ? key.getSample(0, n) : 0.0f;
+            if (stereoKey)
+                scInput = (scInput + (inRange ? key.getSample(1, n) : 0.0f)) * 0.5f;
+
+            float filtered = scInput;
+            if (settings.scHPFEnabled) filtered = hpf.process(filtered);
+            if (settings.scLPFEnabled) filtered = lpf.process(filtered);
+
+            // Envelope state machine
+            bool shouldTrigger = linearToDecibels(std::abs(filtered)) > threshold;
+
+            if (shouldTrigger)
+            {
+                holdCounter = holdSamples;
+                if (state == idle || state == release)
+                    state = attack;
+            }
+
+            switch (state)
+            {
+                case idle:
+                    envelopeState = 0.0f;
+                    break;
+
+                case attack:
+                    envelopeState += attackCoeff * (1.0f - envelopeState);
+                    if (envelopeState >= 0.999f)
+                    {
+                        envelopeState = 1.0f;
+                        state = hold;
+                    }
+                    break;
+
+                case hold:
+                    envelopeState = 1.0f;
+                    if (--holdCounter <= 0 && !shouldTrigger)
+                        state = release;
+                    break;
+
+                case release:
+                    envelopeState -= releaseCoeff * envelopeState;
+                    if (envelopeState < 0.001f)
+                    {
+                        envelopeState = 0.0f;
+                        state = idle;
+                    }
+                    break;
+            }
+
+            float envelope = applyCurveShape(envelopeState, settings.curveShape);
+            float gain = 1.0f - envelope * (1.0f - duckedGain);
+
+            // Zero-crossing gating: a channel only picks up a new gain at a
+            // sign change or near-silence
+            if (settings.zeroCrossing)
+            {
+                if ((lastL >= 0.0f && inL < 0.0f) || (lastL <= 0.0f && inL > 0.0f) || std::abs(inL) < 0.001f)
+                    pendingL = gain;
+                lastL = inL;
+
+                if (stereo)
+                {
+                    if ((lastR >= 0.0f && inR < 0.0f) || (lastR <= 0.0f && inR > 0.0f) || std::abs(inR) < 0.001f)
+                        pendingR = gain;
+                    lastR = inR;
+                }
+            }
+            else
+            {
+                pendingL = pendingR = gain;
+            }
+
+            // Look-ahead delay
+            delayL[(size_t)writePos] = inL;
+            if (stereo)
+                delayR[(size_t)writePos] = inR;
+
+            int readPos = writePos - lookAhead;
+            if (readPos < 0)
+                readPos += delaySize;
+
+            float dryL = delayL[(size_t)readPos];
+            float dryR = stereo ? delayR[(size_t)readPos] : dryL;
+
+            float outL = dryL * dryMix + dryL * pendingL * wetMix;
+            float outR = dryR * dryMix + dryR * pendingR * wetMix;
+
+            if (settings.scListen)
+                outL = outR = filtered;
+
+            writePos = (writePos + 1) % delaySize;
+
+            // Drop the look-ahead from the head
+            auto m = n - lookAhead;
+            if (m >= 0)
+            {
+                result.output.setSample(0, m, outL);
+                if (stereo)
+                    result.output.setSample(1, m, outR);
+                result.gain[(size_t)m] = dryMix + pendingL * wetMix;
+            }
+        }
+    }
+}
@@ -0,0 +1,327 @@
+// ducker_matrix - many keys ducking many stems in one pass.
+//
+// Each --key is a sidechain file (downmixed to mono), each --target a stem
+// to duck. --duck KEY:TARGET=DB sets one cell of the matrix. All keys are
+// detected once and every target gets the deepest of its cells' ducks; see
+// Source/DSP/DuckingMatrix.h. Outputs are <target>_ducked.wav, aligned with
+// the inputs (the look-ahead delay is compensated).
+
+#include <juce_core/juce_core.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <iostream>
+#include "DSP/DuckingMatrix.h"
+#include "Offline/DuckerSettings.h"
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout
+            << "Usage: ducker_matrix [options] --key NAME=FILE ... --target NAME=FILE ... --duck KEY:TARGET=DB ...\n"
+            << "\n"
+            << "Options:\n"
+            << "  --key NAME=FILE         Add a key (sidechain) input, downmixed to mono\n"
+            << "  --target NAME=FILE      Add a target stem to be ducked\n"
+            << "  --duck KEY:TARGET=DB    Cell depth in dB, e.g. dialogue:music=-12 (TARGET * for all)\n"
+            << "  --set NAME:ID=VALUE     Per-key detection (threshold, attack, hold, release,\n"
+            << "                          curveShape, scHPF*, scLPF*) or per-target range/mix\n"
+            << "  --lookahead MS          Look-ahead for all targets (default: 5)\n"
+            << "  --out-dir DIR           Output directory (default: next to each target)\n"
+            << "  --block N               Processing block size (default: 4096)\n"
+            << "  --bits N                Output bit depth: 16, 24 or 32 (default: 24)\n";
+    }
+
+    struct Input
+    {
+        juce::String name;
+        juce::File file;
+        DuckerSettings settings;
+        std::unique_ptr<juce::AudioFormatReader> reader;
+    };
+
+    // "name=rest" or "name:rest"
+    bool split(const juce::String& arg, juce::juce_wchar separator, juce::String& name, juce::String& rest)
+    {
+        auto index = arg.indexOfChar(separator);
+        if (index <= 0)
+            return false;
+
+        name = arg.substring(0, index).trim();
+        rest = arg.substring(index + 1).trim();
+        return rest.isNotEmpty();
+    }
+
+    int indexOf(const std::vector<Input>& inputs, const juce::String& name)
+    {
+        for (size_t i = 0; i < inputs.size(); ++i)
+            if (inputs[i].name == name)
+                return (int)i;
+        return -1;
+    }
+
+    DuckingMatrix::KeySettings toKeySettings(const DuckerSettings& s)
+    {
+        DuckingMatrix::KeySettings key;
+        key.threshold = s.threshold;
+        key.attack = s.attack;
+        key.hold = s.getHoldMs();
+        key.release = s.getReleaseMs();
+        key.curveShape = s.curveShape;
+        key.hpfEnabled = s.scHPFEnabled;
+        key.lpfEnabled = s.scLPFEnabled;
+        key.hpfFreq = s.scHPFFreq;
+        key.lpfFreq = s.scLPFFreq;
+        return key;
+    }
+
+    struct Cell
+    {
+        juce::String key, target;
+        float depthDb = 0.0f;
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::CharPointer_UTF8(argv[i]));
+
+    std::vector<Input> keys, targets;
+    std::vector<Cell> cells;
+    juce::StringArray assignments;
+    float lookAheadMs = 5.0f;
+    juce::File outDir;
+    int blockSize = 4096;
+    int bits = 24;
+
+    auto cwd = juce::File::getCurrentWorkingDirectory();
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto arg = args[i];
+        auto hasValue = i + 1 < args.size();
+        juce::String name, rest;
+
+        if ((arg == "--key" || arg == "--target") && hasValue && split(args[i + 1], '=', name, rest))
+        {
+            auto& list = arg == "--key" ? keys : targets;
+            if (indexOf(list, name) >= 0)
+            {
+                std::cerr << "Duplicate name: " << name << std::endl;
+                return 1;
+            }
+
+            Input input;
+            input.name = name;
+            input.file = cwd.getChildFile(rest);
+            list.push_back(std::move(input));
+            ++i;
+        }
+        else if (arg == "--duck" && hasValue)
+        {
+            juce::String cell, value, target;
+            if (!split(args[++i], '=', cell, value) || !split(cell, ':', name, target))
+            {
+                std::cerr << "Expected KEY:TARGET=DB, got " << args[i] << std::endl;
+                return 1;
+            }
+            cells.push_back({ name, target, (float)value.getDoubleValue() });
+        }
+        else if (arg == "--set" && hasValue)       assignments.add(args[++i]);
+        else if (arg == "--lookahead" && hasValue) lookAheadMs = juce::jlimit(0.0f, 20.0f, (float)args[++i].getDoubleValue());
+        else if (arg == "--out-dir" && hasValue)   outDir = cwd.getChildFile(args[++i]);
+        else if (arg == "--block" && hasValue)     blockSize = juce::jmax(16, args[++i].getIntValue());
+        else if (arg == "--bits" && hasValue)      bits = args[++i].getIntValue();
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (keys.empty() || targets.empty() || cells.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    if ((int)keys.size() > DuckingMatrix::maxKeys || (int)targets.size() > DuckingMatrix::maxTargets)
+    {
+        std::cerr << "At most " << DuckingMatrix::maxKeys << " keys and " << DuckingMatrix::maxTargets
+                  << " targets" << std::endl;
+        return 1;
+    }
+
+    for (auto& assignment : assignments)
+    {
+        juce::String name, rest;
+        int k = -1, t = -1;
+        if (split(assignment, ':', name, rest))
+        {
+            k = indexOf(keys, name);
+            t = indexOf(targets, name);
+        }
+
+        auto* settings = k >= 0 ? &keys[(size_t)k].settings : t >= 0 ? &targets[(size_t)t].settings : nullptr;
+        if (settings == nullptr || !settings->setFromString(rest))
+        {
+            std::cerr << "Unknown parameter assignment: " << assignment << std::endl;
+            return 1;
+        }
+    }
+
+    juce::AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    double sampleRate = 0.0;
+    juce::int64 length = 0;
+
+    for (auto* list : { &keys, &targets })
+    {
+        for (auto& input : *list)
+        {
+            input.reader.reset(formatManager.createReaderFor(input.file));
+            if (input.reader == nullptr)
+            {
+                std::cerr << "Could not read " << input.file.getFullPathName() << std::endl;
+                return 1;
+            }
+
+            if (sampleRate == 0.0)
+                sampleRate = input.reader->sampleRate;
+
+            if (input.reader->sampleRate != sampleRate)
+            {
+                std::cerr << input.file.getFileName() << ": sample rate differs from the other inputs" << std::endl;
+                return 1;
+            }
+
+            // Channels past the limit would be neither delayed nor ducked
+            if (list == &targets && (int)input.reader->numChannels > DuckingMatrix::maxChannelsPerTarget)
+            {
+                std::cerr << input.file.getFileName() << ": " << (int)input.reader->numChannels
+                          << " channels, at most " << DuckingMatrix::maxChannelsPerTarget << " per target" << std::endl;
+                return 1;
+            }
+
+            if (list == &targets)
+                length = juce::jmax(length, input.reader->lengthInSamples);
+        }
+    }
+
+    const int numKeys = (int)keys.size();
+    const int numTargets = (int)targets.size();
+
+    DuckingMatrix matrix;
+    matrix.prepare(sampleRate, blockSize, numKeys, numTargets);
+    matrix.setLookAhead(lookAheadMs);
+
+    for (int k = 0; k < numKeys; ++k)
+        matrix.setKey(k, toKeySettings(keys[(size_t)k].settings));
+
+    for (int t = 0; t < numTargets; ++t)
+        matrix.setTarget(t, { targets[(size_t)t].settings.range, targets[(size_t)t].settings.mix });
+
+    for (auto& cell : cells)
+    {
+        auto k = indexOf(keys, cell.key);
+        auto t = indexOf(targets, cell.target);
+        if (k < 0 || (t < 0 && cell.target != "*"))
+        {
+            std::cerr << "Unknown key or target in --duck " << cell.key << ":" << cell.target << std::endl;
+            return 1;
+        }
+
+        for (int target = 0; target < numTargets; ++target)
+            if (target == t || cell.target == "*")
+                matrix.setDepth(k, target, cell.depthDb);
+    }
+
+    if (outDir != juce::File())
+        outDir.createDirectory();
+
+    std::vector<std::unique_ptr<juce::AudioFormatWriter>> writers;
+    for (auto& target : targets)
+    {
+        auto dir = outDir != juce::File() ? outDir : target.file.getParentDirectory();
+        auto file = dir.getChildFile(target.file.getFileNameWithoutExtension() + "_ducked.wav");
+        file.deleteFile();
+
+        auto stream = std::make_unique<juce::FileOutputStream>(file);
+        juce::WavAudioFormat wav;
+        std::unique_ptr<juce::AudioFormatWriter> writer;
+        if (!stream->failedToOpen())
+            writer.reset(wav.createWriterFor(stream.get(), sampleRate, target.reader->numChannels, bits, {}, 0));
+
+        if (writer == nullptr)
+        {
+            std::cerr << "Could not write " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+
+        stream.release(); // owned by the writer now
+        writers.push_back(std::move(writer));
+    }
+
+    juce::AudioBuffer<float> keyBuffer(2, blockSize);
+    juce::AudioBuffer<float> keyMono(numKeys, blockSize);
+    std::vector<juce::AudioBuffer<float>> targetBuffers;
+    std::vector<juce::AudioBuffer<float>*> targetPointers;
+    for (auto& target : targets)
+        targetBuffers.emplace_back((int)target.reader->numChannels, blockSize);
+    for (auto& buffer : targetBuffers)
+        targetPointers.push_back(&buffer);
+
+    // Run past the end by the latency so the delayed tail comes out too
+    const int latency = matrix.getLatencyInSamples();
+    const auto total = length + latency;
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    for (juce::int64 pos = 0; pos < total; pos += blockSize)
+    {
+        const int n = (int)juce::jmin((juce::int64)blockSize, total - pos);
+
+        for (int k = 0; k < numKeys; ++k)
+        {
+            auto& reader = *keys[(size_t)k].reader;
+            const int numChannels = juce::jmin(2, (int)reader.numChannels);
+            reader.read(&keyBuffer, 0, n, pos, true, numChannels > 1);
+
+            keyMono.copyFrom(k, 0, keyBuffer, 0, 0, n);
+            if (numChannels > 1)
+            {
+                keyMono.addFrom(k, 0, keyBuffer, 1, 0, n);
+                keyMono.applyGain(k, 0, n, 0.5f);
+            }
+        }
+
+        for (int t = 0; t < numTargets; ++t)
+            targets[(size_t)t].reader->read(&targetBuffers[(size_t)t], 0, n, pos, true, true);
+
+        matrix.process(keyMono.getArrayOfReadPointers(), targetPointers.data(), n);
+
+        // Drop the first `latency` samples and stop at each target's own length
+        for (int t = 0; t < numTargets; ++t)
+        {
+            const auto outStart = juce::jmax(pos, (juce::int64)latency);
+            const auto outEnd = juce::jmin(pos + n, targets[(size_t)t].reader->lengthInSamples + latency);
+            if (outEnd > outStart)
+                writers[(size_t)t]->writeFromAudioSampleBuffer(targetBuffers[(size_t)t], (int)(outStart - pos),
+                                                               (int)(outEnd - outStart));
+        }
+    }
+
+    writers.clear();
+
+    auto wall = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    auto audioSeconds = (double)length / sampleRate;
+
+    std::cout << juce::String::formatted("%d key(s) x %d target(s), %.1f s audio in %.2f s wall, %.1fx realtime",
+                                         numKeys, numTargets, audioSeconds, wall,
+                                         wall > 0.0 ? audioSeconds / wall : 0.0)
+              << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+// ducker_pipe - streams raw PCM through the Ducker DSP.
+//
+// Main PCM comes in on stdin (or --in), optional sidechain PCM from a file
+// or named pipe (--sc), and ducked PCM goes out on stdout (or --out), so
+// Ducker can sit between two ffmpeg processes without intermediate files.
+// Diagnostics go to stderr only.
+
+#include <juce_core/juce_core.h>
+#include <iostream>
+#include <csignal>
+#include "Offline/PcmPipe.h"
+
+#if JUCE_WINDOWS
+ #include <io.h>
+ #include <fcntl.h>
+#endif
+
+namespace
+{
+    void printUsage()
+    {
+        std::cerr
+            << "Usage: ffmpeg -i music.mp3 -f f32le -ac 2 -ar 48000 - \\\n"
+            << "     | ducker_pipe --rate 48000 --sc voice.pcm \\\n"
+            << "     | ffmpeg -f f32le -ac 2 -ar 48000 -i - out.m4a\n"
+            << "\n"
+            << "Options:\n"
+            << "  --rate HZ           Sample rate of all streams (default: 48000)\n"
+            << "  --channels N        Main channels, 1 or 2 (default: 2)\n"
+            << "  --format FMT        Main encoding: s16, s24 or f32 (default: f32)\n"
+            << "  --in PATH           Main input (default: stdin)\n"
+            << "  --sc PATH           Sidechain input, file or named pipe (default: main keys itself);\n"
+            << "                      - for stdin, if --in names a file\n"
+            << "  --sc-channels N     Sidechain channels (default: same as main)\n"
+            << "  --sc-format FMT     Sidechain encoding (default: same as main)\n"
+            << "  --out PATH          Output (default: stdout)\n"
+            << "  --out-format FMT    Output encoding (default: same as main)\n"
+            << "  --block N           Frames per block (default: 256)\n"
+            << "  --preset FILE       Plugin state XML with <PARAM id=.. value=../> entries\n"
+            << "  --set ID=VALUE      Override a parameter (e.g. --set threshold=-18)\n";
+    }
+
+    struct ScopedFile
+    {
+        std::FILE* file = nullptr;
+        bool owned = false;
+
+        ~ScopedFile()
+        {
+            if (owned && file != nullptr)
+                std::fclose(file);
+        }
+    };
+
+    bool openStream(ScopedFile& scoped, const juce::String& path, std::FILE* standardStream, const char* mode)
+    {
+        if (path.isEmpty() || path == "-")
+        {
+            scoped.file = standardStream;
+           #if JUCE_WINDOWS
+            _setmode(_fileno(standardStream), _O_BINARY);
+           #endif
+            return true;
+        }
+
+        scoped.file = std::fopen(juce::File::getCurrentWorkingDirectory().getChildFile(path).getFullPathName().toRawUTF8(), mode);
+        scoped.owned = true;
+        return scoped.file != nullptr;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::CharPointer_UTF8(argv[i]));
+
+   #if ! JUCE_WINDOWS
+    // Report a closed downstream pipe as a write error instead of dying silently
+    std::signal(SIGPIPE, SIG_IGN);
+   #endif
+
+    DuckerSettings settings;
+    PipeOptions options;
+    juce::String inPath, scPath, outPath;
+    bool scChannelsSet = false, scFormatSet = false, outFormatSet = false;
+
+    auto cwd = juce::File::getCurrentWorkingDirectory();
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto arg = args[i];
+        auto hasValue = i + 1 < args.size();
+
+        if (arg == "--rate" && hasValue)                  options.sampleRate = args[++i].getDoubleValue();
+        else if (arg == "--channels" && hasValue)         options.main.numChannels = args[++i].getIntValue();
+        else if (arg == "--sc-channels" && hasValue)
+        {
+            options.sidechain.numChannels = args[++i].getIntValue();
+            scChannelsSet = true;
+        }
+        else if ((arg == "--format" || arg == "--sc-format" || arg == "--out-format") && hasValue)
+        {
+            auto& format = arg == "--format" ? options.main : (arg == "--sc-format" ? options.sidechain : options.output);
+            if (!PcmFormat::parseEncoding(args[++i], format.encoding))
+            {
+                std::cerr << "Unknown PCM format: " << args[i] << " (use s16, s24 or f32)" << std::endl;
+                return 1;
+            }
+
+            scFormatSet = scFormatSet || arg == "--sc-format";
+            outFormatSet = outFormatSet || arg == "--out-format";
+        }
+        else if (arg == "--in" && hasValue)               inPath = args[++i];
+        else if (arg == "--sc" && hasValue)               scPath = args[++i];
+        else if (arg == "--out" && hasValue)              outPath = args[++i];
+        else if (arg == "--block" && hasValue)            options.blockSize = args[++i].getIntValue();
+        else if (arg == "--preset" && hasValue)
+        {
+            juce::String error;
+            if (!settings.loadPreset(cwd.getChildFile(args[++i]), error))
+            {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--set" && hasValue)
+        {
+            if (!settings.setFromString(args[++i]))
+            {
+                std::cerr << "Unknown parameter assignment: " << args[i] << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (!scChannelsSet)
+        options.sidechain.numChannels = options.main.numChannels;
+    if (!scFormatSet)
+        options.sidechain.encoding = options.main.encoding;
+    if (!outFormatSet)
+        options.output.encoding = options.main.encoding;
+
+    if (options.sampleRate <= 0.0)
+    {
+        std::cerr << "Invalid sample rate" << std::endl;
+        return 1;
+    }
+
+    // Main and sidechain cannot both be read from stdin
+    auto isStdin = [](const juce::String& path) { return path.isEmpty() || path == "-"; };
+    if (scPath == "-" && isStdin(inPath))
+    {
+        std::cerr << "--sc - needs --in to name a file (the main input is stdin)" << std::endl;
+        return 1;
+    }
+
+    ScopedFile mainIn, scIn, out;
+
+    if (!openStream(mainIn, inPath, stdin, "rb"))
+    {
+        std::cerr << "Could not open " << inPath << std::endl;
+        return 1;
+    }
+
+    if (scPath.isNotEmpty() && !openStream(scIn, scPath, stdin, "rb"))
+    {
+        std::cerr << "Could not open " << scPath << std::endl;
+        return 1;
+    }
+
+    if (!openStream(out, outPath, stdout, "wb"))
+    {
+        std::cerr << "Could not open " << outPath << std::endl;
+        return 1;
+    }
+
+    PipeRenderer renderer(settings, options);
+    juce::String error;
+
+    if (!renderer.run(mainIn.file, scIn.file, out.file, error))
+    {
+        std::cerr << error << std::endl;
+        return 2;
+    }
+
+    std::cerr << renderer.getFramesWritten() << " frames" << std::endl;
+    return 0;
+}
@@ -0,0 +1,401 @@
+// ducker_render - headless batch renderer.
+//
+// Renders main/sidechain file pairs through the Ducker DSP on a thread pool
+// (one job per file) and reports per-file and total realtime factor.
+// With --segments, each file is instead split into segments rendered in
+// parallel, for single multi-hour files. File I/O streams in fixed chunks
+// (memory-mapped reads, read-ahead, write-behind), so memory use does not
+// grow with file length. With --noncausal, the whole key is analysed
+// first and ducks are placed ahead of each onset. With --sweep, every
+// point of a parameter grid is rendered in the same pass.
+
+#include <juce_core/juce_core.h>
+#include <iostream>
+#include <map>
+#include "Offline/OfflineRenderer.h"
+#include "Offline/SegmentRenderer.h"
+#include "Offline/NonCausalRenderer.h"
+#include "Offline/SweepRenderer.h"
+#include "Offline/CachedRenderer.h"
+
+namespace
+{
+    void printUsage()
+    {
+        std::cout
+            << "Usage: ducker_render [options] --job main.wav [sidechain.wav] ...\n"
+            << "\n"
+            << "Options:\n"
+            << "  --job MAIN [SC]     Add a file pair (SC omitted: main keys itself)\n"
+            << "  --jobs FILE         Read jobs from FILE, one per line: main[<TAB>sidechain]\n"
+            << "  --preset FILE       Plugin state XML with <PARAM id=.. value=../> entries\n"
+            << "  --set ID=VALUE      Override a parameter (e.g. --set threshold=-18)\n"
+            << "  --out-dir DIR       Output directory (default: next to each main file)\n"
+            << "  --threads N         Worker threads (default: number of cores)\n"
+            << "  --block N           Processing block size (default: 4096)\n"
+            << "  --bits N            Output bit depth: 16, 24 or 32 (default: 24)\n"
+            << "  --chunk N           Streaming I/O chunk in samples (default: 65536)\n"
+            << "  --no-stream         Plain blocking I/O (no mmap, read-ahead or write-behind)\n"
+            << "  --export-gain       Also write each applied gain track as <output>.dgain\n"
+            << "  --replay FILE       Apply a .dgain track to every main file, skipping detection\n"
+            << "  --cache DIR         Reuse detection for unchanged chunks of earlier renders\n"
+            << "  --cache-limit MB    Trim the cache to this size after rendering (default: 1024, 0: no limit)\n"
+            << "\n"
+            << "Segment-parallel mode (one long file across all cores):\n"
+            << "  --segments N        Split each file into N segments (0: one per thread)\n"
+            << "  --overlap SECONDS   Warm-up pre-roll per segment (default: 2x convergence time)\n"
+            << "  --verify            Also render sequentially and report the max deviation\n"
+            << "  --tolerance X       Max allowed deviation when verifying (default: 1e-4)\n"
+            << "\n"
+            << "Two-pass non-causal mode (whole-file key analysis, no look-ahead limit):\n"
+            << "  --noncausal         Analyse the key first, then duck ahead of each onset\n"
+            << "  --preroll MS        How long before an onset the duck is fully down (default: 20)\n"
+            << "\n"
+            << "Parameter sweep (one output per grid point, plus <output>_sweep.csv):\n"
+            << "  --sweep ID=V1,V2..  Add a sweep axis (repeatable; the grid is their product)\n";
+    }
+
+    juce::File outputFileFor(const juce::File& mainFile, const juce::File& outDir)
+    {
+        auto dir = outDir != juce::File() ? outDir : mainFile.getParentDirectory();
+        return dir.getChildFile(mainFile.getFileNameWithoutExtension() + "_ducked.wav");
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    juce::StringArray args;
+    for (int i = 1; i < argc; ++i)
+        args.add(juce::CharPointer_UTF8(argv[i]));
+
+    DuckerSettings settings;
+    std::vector<RenderJob> jobs;
+    juce::File outDir;
+    int numThreads = juce::SystemStats::getNumCpus();
+    int blockSize = 4096;
+    int bits = 24;
+    StreamingOptions streaming;
+
+    bool segmentMode = false;
+    SegmentRenderOptions segmentOptions;
+
+    bool exportGain = false;
+    juce::File replayTrack;
+    juce::File cacheDir;
+    int cacheLimitMB = 1024;
+
+    bool nonCausalMode = false;
+    NonCausalOptions nonCausalOptions;
+
+    juce::StringArray sweepAxes;
+
+    auto cwd = juce::File::getCurrentWorkingDirectory();
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        auto arg = args[i];
+        auto hasValue = i + 1 < args.size();
+
+        if (arg == "--job" && hasValue)
+        {
+            RenderJob job;
+            job.mainFile = cwd.getChildFile(args[++i]);
+            if (i + 1 < args.size() && !args[i + 1].startsWith("--"))
+                job.sidechainFile = cwd.getChildFile(args[++i]);
+            jobs.push_back(job);
+        }
+        else if (arg == "--jobs" && hasValue)
+        {
+            juce::StringArray lines;
+            lines.addLines(cwd.getChildFile(args[++i]).loadFileAsString());
+
+            for (auto& line : lines)
+            {
+                auto fields = juce::StringArray::fromTokens(line, "\t", "");
+                if (fields.isEmpty() || fields[0].trim().isEmpty())
+                    continue;
+
+                RenderJob job;
+                job.mainFile = cwd.getChildFile(fields[0].trim());
+                if (fields.size() > 1 && fields[1].trim().isNotEmpty())
+                    job.sidechainFile = cwd.getChildFile(fields[1].trim());
+                jobs.push_back(job);
+            }
+        }
+        else if (arg == "--preset" && hasValue)
+        {
+            juce::String error;
+            if (!settings.loadPreset(cwd.getChildFile(args[++i]), error))
+            {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--set" && hasValue)
+        {
+            if (!settings.setFromString(args[++i]))
+            {
+                std::cerr << "Unknown parameter assignment: " << args[i] << std::endl;
+                return 1;
+            }
+        }
+        else if (arg == "--out-dir" && hasValue)   outDir = cwd.getChildFile(args[++i]);
+        else if (arg == "--threads" && hasValue)   numThreads = juce::jmax(1, args[++i].getIntValue());
+        else if (arg == "--block" && hasValue)     blockSize = args[++i].getIntValue();
+        else if (arg == "--bits" && hasValue)      bits = args[++i].getIntValue();
+        else if (arg == "--chunk" && hasValue)     streaming.chunkSamples = juce::jmax(1024, args[++i].getIntValue());
+        else if (arg == "--no-stream")             streaming.enabled = false;
+        else if (arg == "--export-gain")           exportGain = true;
+        else if (arg == "--replay" && hasValue)    replayTrack = cwd.getChildFile(args[++i]);
+        else if (arg == "--cache" && hasValue)     cacheDir = cwd.getChildFile(args[++i]);
+        else if (arg == "--cache-limit" && hasValue) cacheLimitMB = juce::jmax(0, args[++i].getIntValue());
+        else if (arg == "--segments" && hasValue)
+        {
+            segmentMode = true;
+            segmentOptions.numSegments = args[++i].getIntValue();
+        }
+        else if (arg == "--overlap" && hasValue)   segmentOptions.overlapSeconds = args[++i].getDoubleValue();
+        else if (arg == "--verify")                segmentOptions.verify = true;
+        else if (arg == "--tolerance" && hasValue) segmentOptions.tolerance = (float)args[++i].getDoubleValue();
+        else if (arg == "--sweep" && hasValue)     sweepAxes.add(args[++i]);
+        else if (arg == "--noncausal")             nonCausalMode = true;
+        else if (arg == "--preroll" && hasValue)
+        {
+            nonCausalMode = true;
+            nonCausalOptions.preRollMs = juce::jmax(0.0, args[++i].getDoubleValue());
+        }
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    if (jobs.empty())
+    {
+        printUsage();
+        return 1;
+    }
+
+    if (segmentMode && nonCausalMode)
+    {
+        std::cerr << "--segments and --noncausal cannot be combined" << std::endl;
+        return 1;
+    }
+
+    bool sweepMode = !sweepAxes.isEmpty();
+    bool cacheMode = cacheDir != juce::File();
+
+    if (cacheMode && (segmentMode || nonCausalMode || sweepMode || exportGain || replayTrack != juce::File()))
+    {
+        std::cerr << "--cache only works with the standard render" << std::endl;
+        return 1;
+    }
+
+    if ((exportGain || replayTrack != juce::File()) && (segmentMode || nonCausalMode || sweepMode))
+    {
+        std::cerr << "--export-gain and --replay only work with the standard render" << std::endl;
+        return 1;
+    }
+
+    // One track serves all channels: with zero-crossing on, each channel
+    // takes new gains at its own crossings, and listen outputs the key
+    if (exportGain && (settings.zeroCrossing || settings.scListen))
+    {
+        std::cerr << "--export-gain cannot be used with zeroCrossing or scListen on "
+                  << "(the output would not be replayable from one gain track)" << std::endl;
+        return 1;
+    }
+
+    std::vector<SweepVariant> sweepVariants;
+    if (sweepMode)
+    {
+        juce::String error;
+        if (segmentMode || nonCausalMode)
+            error = "--sweep cannot be combined with --segments or --noncausal";
+        else
+            SweepRenderer::expandGrid(settings, sweepAxes, sweepVariants, error);
+
+        if (error.isNotEmpty())
+        {
+            std::cerr << error << std::endl;
+            return 1;
+        }
+    }
+
+    if (outDir != juce::File())
+        outDir.createDirectory();
+
+    // Mains with the same name from different folders would render into the
+    // same file under --out-dir (or the same main listed twice anywhere)
+    std::map<juce::File, const RenderJob*> jobForOutput;
+
+    for (auto& job : jobs)
+    {
+        job.outputFile = outputFileFor(job.mainFile, outDir);
+        job.replayGainTrack = replayTrack;
+        if (exportGain)
+            job.exportGainTrack = job.outputFile.withFileExtension("dgain");
+
+        auto inserted = jobForOutput.emplace(job.outputFile, &job);
+        if (!inserted.second)
+        {
+            std::cerr << "Both " << inserted.first->second->mainFile.getFullPathName()
+                      << " and " << job.mainFile.getFullPathName()
+                      << " would render to " << job.outputFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    // One read-ahead and one write-behind thread per worker
+    streaming.ioThreads = numThreads;
+    OfflineRenderer renderer(settings, blockSize, bits, streaming);
+    std::vector<RenderResult> results(jobs.size());
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    if (segmentMode)
+    {
+        // Files one after another, each spread across the whole pool
+        juce::ThreadPool pool(numThreads);
+        SegmentRenderer segmentRenderer(renderer);
+
+        for (size_t j = 0; j < jobs.size(); ++j)
+        {
+            auto r = segmentRenderer.render(jobs[j], segmentOptions, pool);
+            results[j] = r;
+
+            std::cout << jobs[j].mainFile.getFileName() << ": " << r.numSegments << " segment(s), "
+                      << r.overlapSamples << " samples overlap";
+            if (r.maxDeviation >= 0.0f)
+                std::cout << juce::String::formatted(", max deviation vs sequential %.3g (tolerance %.3g)",
+                                                     (double)r.maxDeviation, (double)segmentOptions.tolerance);
+            std::cout << std::endl;
+        }
+    }
+    else
+    {
+        juce::ThreadPool pool(juce::jmin(numThreads, (int)jobs.size()));
+        std::atomic<int> remaining { (int)jobs.size() };
+        juce::WaitableEvent allDone;
+
+        NonCausalRenderer nonCausalRenderer(renderer, nonCausalOptions);
+        std::vector<NonCausalRenderResult> nonCausalResults(nonCausalMode ? jobs.size() : 0);
+
+        SweepRenderer sweepRenderer(renderer, sweepVariants);
+        std::vector<SweepRenderResult> sweepResults(sweepMode ? jobs.size() : 0);
+
+        std::unique_ptr<CachedRenderer> cachedRenderer;
+        if (cacheMode)
+            cachedRenderer = std::make_unique<CachedRenderer>(renderer, cacheDir);
+        std::vector<CachedRenderResult> cachedResults(cacheMode ? jobs.size() : 0);
+
+        for (size_t j = 0; j < jobs.size(); ++j)
+        {
+            pool.addJob([&, j]
+            {
+                if (nonCausalMode)
+                {
+                    nonCausalResults[j] = nonCausalRenderer.render(jobs[j]);
+                    results[j] = nonCausalResults[j];
+                }
+                else if (sweepMode)
+                {
+                    sweepResults[j] = sweepRenderer.render(jobs[j]);
+                    results[j] = sweepResults[j];
+                }
+                else if (cacheMode)
+                {
+                    cachedResults[j] = cachedRenderer->render(jobs[j]);
+                    results[j] = cachedResults[j];
+                }
+                else
+                {
+                    results[j] = renderer.render(jobs[j]);
+                }
+
+                if (--remaining == 0)
+                    allDone.signal();
+            });
+        }
+
+        allDone.wait();
+
+        for (size_t j = 0; j < nonCausalResults.size(); ++j)
+        {
+            const auto& r = nonCausalResults[j];
+            if (r.ok)
+                std::cout << juce::String::formatted("%s: key pass %.2f s (%.0fx realtime), %d trigger region(s)",
+                                                     jobs[j].mainFile.getFileName().toRawUTF8(), r.analysisSeconds,
+                                                     r.analysisSeconds > 0.0 ? r.audioSeconds / r.analysisSeconds : 0.0,
+                                                     r.numRegions)
+                          << std::endl;
+        }
+
+        for (size_t j = 0; j < cachedResults.size(); ++j)
+        {
+            const auto& r = cachedResults[j];
+            if (!r.ok)
+                continue;
+
+            std::cout << jobs[j].mainFile.getFileName() << ": ";
+            if (r.cacheBypassed)
+                std::cout << "cache bypassed (zero-crossing or sidechain listen)";
+            else
+                std::cout << r.chunksReused << " chunk(s) reused, " << r.chunksComputed << " computed";
+            std::cout << std::endl;
+        }
+
+        // Every job is done with the directory now
+        if (cacheMode && cacheLimitMB > 0)
+            if (auto removed = CachedRenderer::prune(cacheDir, (juce::int64)cacheLimitMB << 20); removed > 0)
+                std::cout << "cache trimmed to " << cacheLimitMB << " MB: " << removed << " file(s) removed" << std::endl;
+
+        for (size_t j = 0; j < sweepResults.size(); ++j)
+        {
+            const auto& r = sweepResults[j];
+            if (!r.ok)
+                continue;
+
+            std::cout << jobs[j].mainFile.getFileName() << ": " << sweepVariants.size() << " variant(s), "
+                      << r.numFilterGroups << " filter group(s)" << std::endl;
+
+            for (size_t v = 0; v < sweepVariants.size(); ++v)
+                std::cout << juce::String::formatted("  %-40s mean GR %6.2f dB  max GR %6.2f dB  ducked %5.1f%%",
+                                                     sweepVariants[v].name.toRawUTF8(),
+                                                     r.stats[v].meanGainReductionDb, r.stats[v].maxGainReductionDb,
+                                                     r.stats[v].duckedFraction * 100.0)
+                          << std::endl;
+        }
+    }
+
+    auto totalWall = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    double totalAudio = 0.0;
+    int failures = 0;
+
+    for (size_t j = 0; j < jobs.size(); ++j)
+    {
+        const auto& r = results[j];
+        if (!r.ok)
+        {
+            std::cerr << "FAILED  " << jobs[j].mainFile.getFileName() << ": " << r.error << std::endl;
+            ++failures;
+            continue;
+        }
+
+        totalAudio += r.audioSeconds;
+        std::cout << juce::String::formatted("%-40s %9.1f s audio %8.2f s wall %8.1fx realtime",
+                                             jobs[j].mainFile.getFileName().toRawUTF8(),
+                                             r.audioSeconds, r.wallSeconds, r.getRealtimeFactor())
+                  << std::endl;
+    }
+
+    std::cout << juce::String::formatted("TOTAL: %d file(s), %.1f s audio in %.2f s wall, %.1fx realtime on %d thread(s)",
+                                         (int)jobs.size() - failures, totalAudio, totalWall,
+                                         totalWall > 0.0 ? totalAudio / totalWall : 0.0,
+                                         segmentMode ? numThreads : juce::jmin(numThreads, (int)jobs.size()))
+              << std::endl;
+
+    return failures == 0 ? 0 : 2;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+// Stand-in for JuceLibraryCode/JuceHeader.h when the plugin sources are
+// compiled into a console tool: the same modules minus the plugin client
+// wrappers, plus the plugin defines the processor uses.
+
+#include <juce_audio_basics/juce_audio_basics.h>
+#include <juce_audio_formats/juce_audio_formats.h>
+#include <juce_audio_processors/juce_audio_processors.h>
+#include <juce_core/juce_core.h>
+#include <juce_data_structures/juce_data_structures.h>
+#include <juce_dsp/juce_dsp.h>
+#include <juce_events/juce_events.h>
+#include <juce_graphics/juce_graphics.h>
+#include <juce_gui_basics/juce_gui_basics.h>
+#include <juce_gui_extra/juce_gui_extra.h>
+
+#ifndef JucePlugin_Name
+ #define JucePlugin_Name "Ducker"
+#endif
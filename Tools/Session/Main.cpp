@@ -0,0 +1,505 @@
+// ducker_session - many-instance session scaling benchmark.
+//
+// Builds a simulated host graph of N DuckerAudioProcessor instances (one
+// per track, each with its own music bed and voice key) plus a mix bus, and
+// runs it block by block on a pool of worker threads as fast as possible.
+// For each N it reports throughput, the distribution of per-block cycle
+// times against the block deadline, and hardware cache misses (Linux
+// perf_event_open, where permitted).
+//
+// Comparing the per-instance cost as N grows shows where working-set size
+// (per-instance state no longer fits in cache) takes over; comparing block
+// sizes at the same N shows the fixed per-block overhead.
+//
+// --check-bus instead checks the envelope bus receiver's fallback: with no
+// sender, a receiver with its own sidechain must duck exactly like a plain
+// instance, one block (its extra reported latency) later.
+
+#include <JuceHeader.h>
+#include <iostream>
+#include "PluginProcessor.h"
+
+#if JUCE_LINUX
+ #include <linux/perf_event.h>
+ #include <sys/ioctl.h>
+ #include <sys/syscall.h>
+ #include <unistd.h>
+#endif
+
+namespace
+{
+    //==============================================================================
+    // Process-wide hardware counters. Opened with inherit before the worker
+    // threads start, so their counts are folded in when they exit.
+    class PerfCounters
+    {
+    public:
+        enum Counter { cacheMisses, cacheReferences, instructions, numCounters };
+
+        PerfCounters()
+        {
+           #if JUCE_LINUX
+            const juce::uint64 configs[numCounters] = { PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_CACHE_REFERENCES,
+                                                        PERF_COUNT_HW_INSTRUCTIONS };
+
+            for (int c = 0; c < numCounters; ++c)
+            {
+                perf_event_attr attr {};
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = configs[c];
+                attr.disabled = 1;
+                attr.inherit = 1;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                fds[c] = (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+            }
+           #endif
+        }
+
+        ~PerfCounters()
+        {
+           #if JUCE_LINUX
+            for (auto fd : fds)
+                if (fd >= 0)
+                    close(fd);
+           #endif
+        }
+
+        bool isAvailable() const { return fds[cacheMisses] >= 0; }
+
+        void start()
+        {
+           #if JUCE_LINUX
+            for (auto fd : fds)
+                if (fd >= 0)
+                {
+                    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                }
+           #endif
+        }
+
+        void stop()
+        {
+           #if JUCE_LINUX
+            for (int c = 0; c < numCounters; ++c)
+            {
+                values[c] = 0;
+                if (fds[c] >= 0)
+                {
+                    ioctl(fds[c], PERF_EVENT_IOC_DISABLE, 0);
+                    if (read(fds[c], &values[c], sizeof(values[c])) != (ssize_t)sizeof(values[c]))
+                        values[c] = 0;
+                }
+            }
+           #endif
+        }
+
+        juce::uint64 get(Counter c) const { return values[c]; }
+
+    private:
+        int fds[numCounters] = { -1, -1, -1 };
+        juce::uint64 values[numCounters] = {};
+    };
+
+    //==============================================================================
+    // Shared read-only material: a music bed for the tracks and a voice-like
+    // key (syllable-rate noise bursts with pauses) for their sidechains
+    struct Material
+    {
+        juce::AudioBuffer<float> music, voice;
+
+        Material(double sampleRate, double seconds)
+        {
+            auto length = (int)(sampleRate * seconds);
+            music.setSize(2, length);
+            voice.setSize(2, length);
+
+            juce::Random random(42);
+            const double chord[] = { 110.0, 164.8, 220.0, 277.2, 329.6 };
+
+            for (int i = 0; i < length; ++i)
+            {
+                auto t = i / sampleRate;
+
+                float bed = 0.0f;
+                for (auto f : chord)
+                    bed += 0.06f * (float)std::sin(juce::MathConstants<double>::twoPi * f * t);
+                bed += 0.02f * (random.nextFloat() * 2.0f - 1.0f);
+
+                // ~4 syllables/s in 3 s phrases with 1.5 s pauses
+                auto phrase = std::fmod(t, 4.5) < 3.0 ? 1.0f : 0.0f;
+                auto syllable = (float)juce::jmax(0.0, std::sin(juce::MathConstants<double>::pi * 4.0 * t));
+                auto speech = phrase * syllable * 0.4f * (random.nextFloat() * 2.0f - 1.0f);
+
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    music.setSample(ch, i, bed);
+                    voice.setSample(ch, i, speech);
+                }
+            }
+        }
+    };
+
+    // One track: a plugin instance and its I/O buffer (main L/R + sidechain L/R)
+    struct Track
+    {
+        std::unique_ptr<DuckerAudioProcessor> processor;
+        juce::AudioBuffer<float> buffer;
+        juce::MidiBuffer midi;
+        int materialOffset = 0;
+
+        void process(const Material& material, juce::int64 blockIndex, int blockSize)
+        {
+            auto length = material.music.getNumSamples();
+            auto start = (int)((materialOffset + blockIndex * blockSize) % (length - blockSize));
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                buffer.copyFrom(ch, 0, material.music, ch, start, blockSize);
+                buffer.copyFrom(ch + 2, 0, material.voice, ch, start, blockSize);
+            }
+
+            processor->processBlock(buffer, midi);
+        }
+    };
+
+    //==============================================================================
+    // Tracks are independent graph nodes; workers pull them off a shared
+    // counter each cycle, and the calling thread joins in as one worker.
+    class HostGraph
+    {
+    public:
+        HostGraph(std::vector<Track>& t, const Material& m, int numThreads, int block)
+            : tracks(t), material(m), blockSize(block)
+        {
+            for (int i = 1; i < numThreads; ++i)
+            {
+                workers.push_back(std::make_unique<Worker>(*this));
+                workers.back()->startThread(juce::Thread::Priority::highest);
+            }
+        }
+
+        ~HostGraph()
+        {
+            for (auto& w : workers)
+            {
+                w->signalThreadShouldExit();
+                w->start.signal();
+            }
+
+            for (auto& w : workers)
+                w->stopThread(2000);
+        }
+
+        void processCycle(juce::int64 blockIndex)
+        {
+            currentBlock = blockIndex;
+            nextTrack = 0;
+            remaining = (int)tracks.size();
+
+            for (auto& w : workers)
+                w->start.signal();
+
+            runTracks();
+            done.wait();
+        }
+
+    private:
+        struct Worker : juce::Thread
+        {
+            explicit Worker(HostGraph& g) : juce::Thread("Session worker"), graph(g) {}
+
+            void run() override
+            {
+                while (!threadShouldExit())
+                {
+                    start.wait();
+                    if (threadShouldExit())
+                        break;
+                    graph.runTracks();
+                }
+            }
+
+            HostGraph& graph;
+            juce::WaitableEvent start;
+        };
+
+        void runTracks()
+        {
+            for (;;)
+            {
+                auto index = nextTrack.fetch_add(1);
+                if (index >= (int)tracks.size())
+                    return;
+
+                tracks[(size_t)index].process(material, currentBlock, blockSize);
+
+                if (remaining.fetch_sub(1) == 1)
+                    done.signal();
+            }
+        }
+
+        std::vector<Track>& tracks;
+        const Material& material;
+        int blockSize;
+        juce::int64 currentBlock = 0;
+        std::atomic<int> nextTrack { 0 }, remaining { 0 };
+        juce::WaitableEvent done;
+        std::vector<std::unique_ptr<Worker>> workers;
+    };
+
+    //==============================================================================
+    struct Options
+    {
+        std::vector<int> instanceCounts { 1, 8, 32, 64, 128, 200, 400 };
+        std::vector<int> blockSizes { 64, 512 };
+        int numThreads = juce::jmax(1, juce::SystemStats::getNumPhysicalCpus());
+        double sampleRate = 48000.0;
+        double audioSeconds = 10.0;
+    };
+
+    std::vector<int> parseList(const juce::String& text)
+    {
+        std::vector<int> values;
+        for (auto& token : juce::StringArray::fromTokens(text, ",", ""))
+            if (token.getIntValue() > 0)
+                values.push_back(token.getIntValue());
+        return values;
+    }
+
+    double percentile(std::vector<double>& sorted, double p)
+    {
+        auto index = (size_t)juce::jlimit(0.0, (double)sorted.size() - 1.0, std::ceil(p * (double)sorted.size()) - 1.0);
+        return sorted[index];
+    }
+
+    void runConfiguration(const Options& options, const Material& material, int numInstances, int blockSize)
+    {
+        std::vector<Track> tracks((size_t)numInstances);
+        for (int i = 0; i < numInstances; ++i)
+        {
+            auto& track = tracks[(size_t)i];
+            track.processor = std::make_unique<DuckerAudioProcessor>();
+            track.processor->enableAllBuses();
+            track.processor->setRateAndBufferSizeDetails(options.sampleRate, blockSize);
+            track.processor->prepareToPlay(options.sampleRate, blockSize);
+            track.buffer.setSize(4, blockSize);
+            track.materialOffset = (int)((juce::int64)i * 7919 * 13 % material.music.getNumSamples());
+        }
+
+        juce::AudioBuffer<float> mixBus(2, blockSize);
+        auto numBlocks = (juce::int64)(options.audioSeconds * options.sampleRate / blockSize);
+        std::vector<double> cycleMs;
+        cycleMs.reserve((size_t)numBlocks);
+
+        PerfCounters counters;
+        counters.start();
+        auto startTicks = juce::Time::getHighResolutionTicks();
+
+        {
+            HostGraph graph(tracks, material, options.numThreads, blockSize);
+
+            for (juce::int64 b = 0; b < numBlocks; ++b)
+            {
+                auto cycleStart = juce::Time::getHighResolutionTicks();
+
+                graph.processCycle(b);
+
+                // Mix bus on the calling thread, as a host's master would
+                mixBus.clear();
+                for (auto& track : tracks)
+                    for (int ch = 0; ch < 2; ++ch)
+                        mixBus.addFrom(ch, 0, track.buffer, ch, 0, blockSize);
+
+                cycleMs.push_back(juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - cycleStart) * 1000.0);
+            }
+        } // workers exit here, folding their counts into the process counters
+
+        auto wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+        counters.stop();
+
+        for (auto& track : tracks)
+            track.processor->releaseResources();
+
+        std::sort(cycleMs.begin(), cycleMs.end());
+        auto deadlineMs = blockSize / options.sampleRate * 1000.0;
+        auto overruns = std::count_if(cycleMs.begin(), cycleMs.end(), [&](double ms) { return ms > deadlineMs; });
+
+        auto instanceBlocks = (double)numBlocks * numInstances;
+        auto nsPerInstanceSample = wallSeconds * 1.0e9 * options.numThreads / (instanceBlocks * blockSize);
+        auto realtimeFactor = options.audioSeconds / wallSeconds;
+
+        std::cout << juce::String::formatted("%5d %5d %7.1fx %9.2f %8.3f %8.3f %8.3f %8.3f %6.1f%% %6d",
+                                             numInstances, blockSize, realtimeFactor, nsPerInstanceSample,
+                                             percentile(cycleMs, 0.5), percentile(cycleMs, 0.99),
+                                             percentile(cycleMs, 0.999), cycleMs.back(),
+                                             100.0 * percentile(cycleMs, 0.99) / deadlineMs, (int)overruns);
+
+        if (counters.isAvailable())
+            std::cout << juce::String::formatted(" %10.1f %7.2f%% %10.0f",
+                                                 counters.get(PerfCounters::cacheMisses) / instanceBlocks,
+                                                 100.0 * counters.get(PerfCounters::cacheMisses)
+                                                     / juce::jmax((juce::uint64)1, counters.get(PerfCounters::cacheReferences)),
+                                                 counters.get(PerfCounters::instructions) / instanceBlocks);
+        else
+            std::cout << "        n/a      n/a        n/a";
+
+        std::cout << std::endl;
+    }
+
+    //==============================================================================
+    // Renders the material through a plain instance and through a receiver
+    // on a bus nobody sends to, in host blocks of hostBlockSize after
+    // preparing for blockSize (larger host blocks take the receiver's
+    // other local-detection path). Returns the max deviation once the
+    // receiver's output is shifted back by its extra latency.
+    float checkReceiverFallback(const Options& options, const Material& material, int blockSize, int hostBlockSize,
+                                int& extraLatency)
+    {
+        DuckerAudioProcessor plain, receiver;
+        for (auto* processor : { &plain, &receiver })
+        {
+            processor->enableAllBuses();
+            processor->setRateAndBufferSizeDetails(options.sampleRate, blockSize);
+            processor->prepareToPlay(options.sampleRate, blockSize);
+        }
+
+        receiver.setEnvelopeBus(DuckerAudioProcessor::BusRole::receive, "ducker_session no sender");
+
+        auto length = juce::jmin(material.music.getNumSamples(), (int)(options.sampleRate * 5.0));
+        length -= length % hostBlockSize;
+
+        juce::AudioBuffer<float> buffer(4, hostBlockSize);
+        juce::MidiBuffer midi;
+        std::array<juce::AudioBuffer<float>, 2> outputs;
+
+        for (size_t p = 0; p < 2; ++p)
+        {
+            auto& processor = p == 0 ? plain : receiver;
+            outputs[p].setSize(2, length);
+
+            for (int start = 0; start < length; start += hostBlockSize)
+            {
+                for (int ch = 0; ch < 2; ++ch)
+                {
+                    buffer.copyFrom(ch, 0, material.music, ch, start, hostBlockSize);
+                    buffer.copyFrom(ch + 2, 0, material.voice, ch, start, hostBlockSize);
+                }
+
+                processor.processBlock(buffer, midi);
+
+                for (int ch = 0; ch < 2; ++ch)
+                    outputs[p].copyFrom(ch, start, buffer, ch, 0, hostBlockSize);
+            }
+        }
+
+        extraLatency = receiver.getLatencySamples() - plain.getLatencySamples();
+        receiver.setEnvelopeBus(DuckerAudioProcessor::BusRole::off, {});
+
+        float maxDeviation = 0.0f;
+        for (int ch = 0; ch < 2; ++ch)
+        {
+            auto* expected = outputs[0].getReadPointer(ch);
+            auto* actual = outputs[1].getReadPointer(ch);
+
+            for (int i = 0; i + extraLatency < length; ++i)
+                maxDeviation = juce::jmax(maxDeviation, std::abs(actual[i + extraLatency] - expected[i]));
+        }
+
+        return maxDeviation;
+    }
+
+    bool checkBus(const Options& options, const Material& material)
+    {
+        bool ok = true;
+
+        for (auto blockSize : options.blockSizes)
+        {
+            for (auto hostBlockSize : { blockSize, 2 * blockSize })
+            {
+                int extraLatency = 0;
+                auto deviation = checkReceiverFallback(options, material, blockSize, hostBlockSize, extraLatency);
+                auto passed = extraLatency == blockSize && deviation <= 1.0e-6f;
+                ok = ok && passed;
+
+                std::cout << juce::String::formatted("receiver without sender, block %d, host blocks %d: "
+                                                     "extra latency %d, max deviation %.3g",
+                                                     blockSize, hostBlockSize, extraLatency, (double)deviation)
+                          << (passed ? "  ok" : "  FAIL") << std::endl;
+            }
+        }
+
+        return ok;
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: ducker_session [options]\n"
+            << "\n"
+            << "Options:\n"
+            << "  --instances LIST    Instance counts to run (default: 1,8,32,64,128,200,400)\n"
+            << "  --blocks LIST       Block sizes (default: 64,512)\n"
+            << "  --threads N         Worker threads incl. the calling thread (default: physical cores)\n"
+            << "  --rate HZ           Sample rate (default: 48000)\n"
+            << "  --seconds S         Audio simulated per configuration (default: 10)\n"
+            << "  --check-bus         Only check envelope-bus receivers against plain instances\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    // APVTS and the processor expect a message manager to exist
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    Options options;
+    bool busCheck = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg(juce::CharPointer_UTF8(argv[i]));
+        auto hasValue = i + 1 < argc;
+        auto value = hasValue ? juce::String(juce::CharPointer_UTF8(argv[i + 1])) : juce::String();
+
+        if (arg == "--instances" && hasValue)    { options.instanceCounts = parseList(value); ++i; }
+        else if (arg == "--blocks" && hasValue)  { options.blockSizes = parseList(value); ++i; }
+        else if (arg == "--threads" && hasValue) { options.numThreads = juce::jmax(1, value.getIntValue()); ++i; }
+        else if (arg == "--rate" && hasValue)    { options.sampleRate = juce::jmax(8000.0, value.getDoubleValue()); ++i; }
+        else if (arg == "--seconds" && hasValue) { options.audioSeconds = juce::jmax(0.5, value.getDoubleValue()); ++i; }
+        else if (arg == "--check-bus")           busCheck = true;
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    Material material(options.sampleRate, 20.0);
+
+    if (busCheck)
+        return checkBus(options, material) ? 0 : 1;
+
+    std::cout << "Per-instance state: sizeof(DuckerAudioProcessor) = " << sizeof(DuckerAudioProcessor)
+              << " bytes (Ducker " << sizeof(Ducker) << ", TelemetryFifo " << sizeof(TelemetryFifo)
+              << ", SpectrumAnalyser " << sizeof(SpectrumAnalyser) << ") plus heap\n"
+              << options.numThreads << " thread(s), " << options.sampleRate << " Hz, "
+              << options.audioSeconds << " s of audio per row\n\n";
+
+    std::cout << "    N block realtime ns/inst-smp  p50 ms   p99 ms p99.9 ms   max ms p99/dl  overruns"
+              << " LLCmiss/blk  miss%  instr/blk" << std::endl;
+
+    for (auto blockSize : options.blockSizes)
+        for (auto numInstances : options.instanceCounts)
+            runConfiguration(options, material, numInstances, blockSize);
+
+    // Allocations, locks and per-instance deadline misses seen in processBlock
+    if (RealtimeSafety::isEnabled)
+    {
+        std::cout << "\n" << RealtimeSafety::getReport() << std::flush;
+        RealtimeSafety::reset();   // don't repeat it at exit
+    }
+
+    return 0;
+}
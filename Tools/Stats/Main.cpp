@@ -0,0 +1,239 @@
+// ducker_stats - reads the live counters of running Ducker processes.
+//
+// Processes started with DUCKER_STATS=1 publish per-instance counters in a
+// POSIX shared-memory segment (Source/Diagnostics/LiveStats.h). This maps
+// each segment read-only and prints one row per process: blocks, audio
+// processed, realtime factor (audio time / time spent in processBlock), peak
+// block time, deadline misses, triggers and time spent ducked. With --watch
+// it refreshes and the realtime factor covers the last interval only.
+
+#include <juce_core/juce_core.h>
+#include <iostream>
+#include <map>
+#include "Diagnostics/LiveStats.h"
+
+#if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+ #include <cerrno>
+ #include <csignal>
+ #include <sys/mman.h>
+#endif
+
+namespace
+{
+    struct Options
+    {
+        juce::Array<juce::int64> processIds;   // empty: every segment found
+        bool perInstance = false;
+        bool clean = false;
+        double watchSeconds = 0.0;
+    };
+
+    // Totals for one process or instance
+    struct Row
+    {
+        LiveStats::Snapshot values {};
+        int numInstances = 0;
+
+        void add(const LiveStats::Snapshot& s)
+        {
+            for (size_t i = 0; i < LiveStats::numFields; ++i)
+            {
+                if (i == (size_t)LiveStats::peakBlockNs || i == (size_t)LiveStats::sampleRate)
+                    values[i] = juce::jmax(values[i], s[i]);
+                else
+                    values[i] += s[i];
+            }
+            ++numInstances;
+        }
+
+        juce::uint64 operator[](LiveStats::Field f) const { return values[(size_t)f]; }
+    };
+
+    bool isAlive(juce::int64 processId)
+    {
+       #if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+        return kill((pid_t)processId, 0) == 0 || errno == EPERM;
+       #else
+        juce::ignoreUnused(processId);
+        return true;
+       #endif
+    }
+
+    // Segments are only enumerable where shm is a filesystem (Linux)
+    juce::Array<juce::int64> findProcesses()
+    {
+        juce::Array<juce::int64> ids;
+
+       #if JUCE_LINUX
+        for (const auto& entry : juce::RangedDirectoryIterator(juce::File("/dev/shm"), false, "ducker-stats.*"))
+        {
+            auto id = entry.getFile().getFileExtension().substring(1).getLargeIntValue();
+            if (id > 0)
+                ids.add(id);
+        }
+        ids.sort();
+       #endif
+
+        return ids;
+    }
+
+    juce::String formatRealtime(double audioSeconds, double busySeconds)
+    {
+        return busySeconds > 0.0 ? juce::String(audioSeconds / busySeconds, 1) + "x" : juce::String("-");
+    }
+
+    void printRow(const juce::String& label, const Row& row, const Row* previous)
+    {
+        auto rate = (double)juce::jmax((juce::uint64)1, row[LiveStats::sampleRate]);
+        auto audioSeconds = (double)row[LiveStats::samples] / rate;
+        auto busySeconds = (double)row[LiveStats::busyNs] * 1.0e-9;
+
+        // Counters only grow unless an instance was replaced in between
+        if (previous != nullptr && (row[LiveStats::samples] < (*previous)[LiveStats::samples]
+                                    || row[LiveStats::busyNs] < (*previous)[LiveStats::busyNs]))
+            previous = nullptr;
+
+        auto realtime = previous != nullptr
+                            ? formatRealtime((double)(row[LiveStats::samples] - (*previous)[LiveStats::samples]) / rate,
+                                             (double)(row[LiveStats::busyNs] - (*previous)[LiveStats::busyNs]) * 1.0e-9)
+                            : formatRealtime(audioSeconds, busySeconds);
+
+        // Ducked time is per instance, so a process's share is averaged over them
+        auto duckedShare = row[LiveStats::samples] > 0
+                               ? 100.0 * (double)row[LiveStats::duckedSamples] / (double)row[LiveStats::samples]
+                               : 0.0;
+
+        std::cout << juce::String::formatted("%-14s %4d %11llu %10.1f %9s %8.3f %7llu %9llu %7.1f%%",
+                                             label.toRawUTF8(), row.numInstances,
+                                             (unsigned long long)row[LiveStats::blocks], audioSeconds,
+                                             realtime.toRawUTF8(), (double)row[LiveStats::peakBlockNs] * 1.0e-6,
+                                             (unsigned long long)row[LiveStats::deadlineMisses],
+                                             (unsigned long long)row[LiveStats::triggers], duckedShare)
+                  << "\n";
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: ducker_stats [options]\n"
+            << "\n"
+            << "Reads processes started with DUCKER_STATS=1.\n"
+            << "\n"
+            << "Options:\n"
+            << "  --pid LIST          Process IDs to read (default: every segment in /dev/shm)\n"
+            << "  --instances         One row per plugin instance as well\n"
+            << "  --watch S           Refresh every S seconds; realtime factor over the interval\n"
+            << "  --clean             Remove segments left by processes that no longer exist\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        juce::String arg(juce::CharPointer_UTF8(argv[i]));
+        auto hasValue = i + 1 < argc;
+        auto value = hasValue ? juce::String(juce::CharPointer_UTF8(argv[i + 1])) : juce::String();
+
+        if (arg == "--pid" && hasValue)
+        {
+            for (auto& id : juce::StringArray::fromTokens(value, ",", {}))
+                options.processIds.add(id.getLargeIntValue());
+            ++i;
+        }
+        else if (arg == "--instances")          { options.perInstance = true; }
+        else if (arg == "--watch" && hasValue)  { options.watchSeconds = juce::jmax(0.1, value.getDoubleValue()); ++i; }
+        else if (arg == "--clean")              { options.clean = true; }
+        else
+        {
+            printUsage();
+            return arg == "--help" ? 0 : 1;
+        }
+    }
+
+    std::map<juce::String, Row> previousRows;
+
+    for (;;)
+    {
+        auto processIds = options.processIds.isEmpty() ? findProcesses() : options.processIds;
+        std::map<juce::String, Row> rows;
+
+        std::cout << "process        inst      blocks    audio s  realtime  peak ms  misses  triggers  ducked\n";
+
+        for (auto processId : processIds)
+        {
+            if (!isAlive(processId))
+            {
+               #if JUCE_LINUX || JUCE_MAC || JUCE_BSD
+                if (options.clean)
+                {
+                    shm_unlink(LiveStats::getSegmentName(processId).toRawUTF8());
+                    std::cout << juce::String(processId) << ": removed stale segment\n";
+                    continue;
+                }
+               #endif
+                std::cout << juce::String(processId) << ": process has exited (stale segment, see --clean)\n";
+                continue;
+            }
+
+            LiveStats::SegmentView view(processId);
+            if (view.get() == nullptr)
+            {
+                std::cout << juce::String(processId) << ": no readable stats segment\n";
+                continue;
+            }
+
+            auto processLabel = juce::String(processId);
+            auto& total = rows[processLabel];
+            juce::Array<std::pair<juce::String, Row>> instances;
+
+            for (int s = 0; s < LiveStats::maxInstances; ++s)
+            {
+                auto& slot = view.get()->slots[(size_t)s];
+                if (slot.active.load(std::memory_order_acquire) == 0)
+                    continue;
+
+                LiveStats::Snapshot snapshot;
+                if (!LiveStats::read(slot, snapshot))
+                    continue;
+
+                total.add(snapshot);
+
+                if (options.perInstance)
+                {
+                    Row row;
+                    row.add(snapshot);
+                    instances.add({ processLabel + "/" + juce::String(s), row });
+                }
+            }
+
+            auto find = [&](const juce::String& label) -> const Row*
+            {
+                auto it = previousRows.find(label);
+                return it != previousRows.end() ? &it->second : nullptr;
+            };
+
+            printRow(processLabel, total, find(processLabel));
+
+            for (auto& [label, row] : instances)
+            {
+                printRow("  " + label, row, find(label));
+                rows[label] = row;
+            }
+        }
+
+        if (processIds.isEmpty())
+            std::cout << "(no Ducker processes publishing stats)\n";
+
+        if (options.watchSeconds <= 0.0)
+            break;
+
+        previousRows = std::move(rows);
+        std::cout << std::endl;
+        juce::Thread::sleep((int)(options.watchSeconds * 1000.0));
+    }
+
+    return 0;
+}